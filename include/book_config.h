@@ -0,0 +1,28 @@
+/**
+ * @file book_config.h
+ * @brief Construction-time settings shared by the OrderBook and its price ladders.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef BOOK_CONFIG_H
+ #define BOOK_CONFIG_H
+ 
+ /**
+  * @struct BookConfig
+  * @brief Per-book instrument settings.
+  *
+  * Values are decimal prices; the book converts them to ticks once at
+  * construction. The price band is only used by ladders that pre-size their
+  * storage (DenseLadder); the default tree-based ladder accepts any price.
+  */
+ struct BookConfig
+ {
+     double tickSize = 0.01;  ///< Minimum price increment
+     double minPrice = 0.0;   ///< Lowest price accepted by a banded ladder
+     double maxPrice = 0.0;   ///< Highest price accepted by a banded ladder
+     bool directOrderIds = false; ///< Index dense, engine-assigned IDs by array slot (see OrderIndex)
+ };
+ 
+ #endif // BOOK_CONFIG_H
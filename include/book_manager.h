@@ -0,0 +1,170 @@
+/**
+ * @file book_manager.h
+ * @brief Multi-symbol engine layer routing orders to lazily created per-symbol books.
+ *
+ * Symbols are interned once into dense SymbolIds, so routing an order is an
+ * index into a vector of books rather than a string hash. A book is only
+ * constructed when its symbol first receives an order, and starts empty (no
+ * pool chunk or index window until orders arrive), so one process can host a
+ * large instrument universe where most symbols are quiet.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef BOOK_MANAGER_H
+ #define BOOK_MANAGER_H
+ 
+ #include "book_config.h"
+ #include "order.h"
+ #include "order_book.h"
+ #include <cstddef>
+ #include <cstdint>
+ #include <memory>
+ #include <optional>
+ #include <stdexcept>
+ #include <string>
+ #include <unordered_map>
+ #include <vector>
+ 
+ /// Dense integer identifying an interned symbol.
+ using SymbolId = std::uint32_t;
+ 
+ /**
+  * @class SymbolTable
+  * @brief Interns symbol strings to dense SymbolIds (0, 1, 2, ... in first-seen order).
+  *
+  * Names live in the table's hash nodes, so a reference from name() stays
+  * valid (and its characters unchanged) as more symbols are interned.
+  */
+ class SymbolTable
+ {
+ public:
+     /// @brief Id of @p symbol, assigning the next id if it is new.
+     SymbolId intern(const std::string &symbol);
+ 
+     /// @brief Id of @p symbol if it has been interned.
+     std::optional<SymbolId> find(const std::string &symbol) const;
+ 
+     /**
+      * @brief Symbol string of @p id.
+      * @throws std::out_of_range if @p id was not issued by this table.
+      */
+     const std::string &name(SymbolId id) const { return *names.at(id); }
+ 
+     /// @brief Number of interned symbols.
+     std::size_t size() const { return names.size(); }
+ 
+ private:
+     std::unordered_map<std::string, SymbolId> ids;  ///< Symbol -> id
+     std::vector<const std::string *> names;         ///< Id -> symbol (the key in ids)
+ };
+ 
+ /**
+  * @class BookManager
+  * @brief Owns one OrderBook per symbol and routes symbol-tagged requests to it.
+  *
+  * Books share the manager's default BookConfig unless configure() gives a
+  * symbol its own before the book is created. Export settings apply to every
+  * book; each writes to its own subdirectory named after the symbol.
+  */
+ class BookManager
+ {
+ public:
+     /**
+      * @brief Construct an empty manager.
+      * @param defaults Config for books without a per-symbol override.
+      */
+     explicit BookManager(const BookConfig &defaults = BookConfig{}) : defaults(defaults) {}
+ 
+     /// @brief Intern @p symbol, returning its routing id.
+     SymbolId intern(const std::string &symbol);
+ 
+     /// @brief Id of @p symbol if it has been interned.
+     std::optional<SymbolId> findSymbol(const std::string &symbol) const { return symbols.find(symbol); }
+ 
+     /// @brief Symbol string of @p id.
+     const std::string &symbolName(SymbolId id) const { return symbols.name(id); }
+ 
+     /// @brief Number of interned symbols.
+     std::size_t symbolCount() const { return symbols.size(); }
+ 
+     /// @brief Number of books created so far.
+     std::size_t bookCount() const { return liveBooks; }
+ 
+     /**
+      * @brief Give symbol @p id its own config (tick size, band, ID mode).
+      * @return false if its book already exists (the config is then ignored).
+      * @throws std::out_of_range if @p id was not interned by this manager.
+      */
+     bool configure(SymbolId id, const BookConfig &config);
+ 
+     /**
+      * @brief Book of symbol @p id, created on first use.
+      * @throws std::out_of_range if @p id was not interned by this manager.
+      */
+     OrderBook &book(SymbolId id)
+     {
+         OrderBook *existing = books.at(id).get();
+         return existing ? *existing : create(id);
+     }
+ 
+     /// @brief Book of symbol @p id, or nullptr if it has not been created.
+     OrderBook *findBook(SymbolId id) { return id < books.size() ? books[id].get() : nullptr; }
+     const OrderBook *findBook(SymbolId id) const { return id < books.size() ? books[id].get() : nullptr; }
+ 
+     /// @brief Route an order to symbol @p id's book (see OrderBook::addOrder).
+     void addOrder(SymbolId id, const Order &order) { book(id).addOrder(order); }
+ 
+     /// @brief Route a cancel to symbol @p id's book; false if the book or order does not exist.
+     bool cancelOrder(SymbolId id, int orderId)
+     {
+         OrderBook *target = findBook(id);
+         return target && target->cancelOrder(orderId);
+     }
+ 
+     /// @brief Route a modify to symbol @p id's book; false if the book or order does not exist.
+     bool modifyOrder(SymbolId id, int orderId, int newQty, Price newPrice, long newTimestamp)
+     {
+         OrderBook *target = findBook(id);
+         return target && target->modifyOrder(orderId, newQty, newPrice, newTimestamp);
+     }
+ 
+     /**
+      * @brief Advance every book's clock to @p now (see OrderBook::advanceTime).
+      *
+      * Books created later start at the latest time passed here.
+      * @return Total number of orders expired.
+      */
+     std::size_t advanceTime(long now);
+ 
+     /// @brief Enable or disable auto-export on existing and future books.
+     void setAutoExport(bool on);
+ 
+     /// @brief Set the export root for existing and future books (one subdirectory per symbol).
+     void setExportDir(const std::string &dir);
+ 
+     /// @brief Visit every created book as fn(SymbolId, OrderBook&), in id order.
+     template <typename Fn>
+     void forEachBook(Fn &&fn)
+     {
+         for (SymbolId id = 0; id < books.size(); ++id)
+             if (books[id])
+                 fn(id, *books[id]);
+     }
+ 
+ private:
+     /// @brief Construct symbol @p id's book with its config and the current export settings.
+     OrderBook &create(SymbolId id);
+ 
+     BookConfig defaults;                               ///< Config for symbols without an override
+     SymbolTable symbols;                               ///< Symbol interning
+     std::vector<std::unique_ptr<OrderBook>> books;     ///< Book per SymbolId (null until first use)
+     std::vector<std::optional<BookConfig>> overrides;  ///< Per-symbol config, by SymbolId
+     std::size_t liveBooks = 0;                         ///< Books created
+     long clock = 0;                                    ///< Latest time passed to advanceTime
+     bool autoExport = true;                            ///< Applied to every book
+     std::string exportDir = "exports";                 ///< Export root
+ };
+ 
+ #endif // BOOK_MANAGER_H
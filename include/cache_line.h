@@ -0,0 +1,17 @@
+/**
+ * @file cache_line.h
+ * @brief Cache line size used to pad and align data shared between threads.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef CACHE_LINE_H
+ #define CACHE_LINE_H
+ 
+ #include <cstddef>
+ 
+ /// Cache line size assumed for padding shared counters.
+ inline constexpr std::size_t CacheLine = 64;
+ 
+ #endif // CACHE_LINE_H
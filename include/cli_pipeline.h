@@ -0,0 +1,150 @@
+/**
+ * @file cli_pipeline.h
+ * @brief Staged command pipeline behind the CLI: decode, sequence/journal, match, encode.
+ *
+ * Each input line travels through four stages sharing one StageRing of
+ * CliRequest slots:
+ *
+ *  1. decode   (caller's thread): read a line, parse it into the slot
+ *  2. sequence (own thread): assign order IDs and priority timestamps, append to the journal
+ *  3. match    (own thread): apply the request to the BookManager
+ *  4. encode   (own thread): echo the line and write its response
+ *
+ * Only the match stage touches the books, so matching stays single-threaded
+ * and its result depends only on the sequenced requests; parsing, journal
+ * writes and terminal output overlap with it instead of stalling it. Stages
+ * hand over whole batches, and output is flushed once per batch.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef CLI_PIPELINE_H
+ #define CLI_PIPELINE_H
+ 
+ #include "book_config.h"
+ #include "book_manager.h"
+ #include "order.h"
+ #include "price.h"
+ #include "stage_ring.h"
+ #include <cstddef>
+ #include <cstdint>
+ #include <fstream>
+ #include <iosfwd>
+ #include <string>
+ #include <vector>
+ 
+ /**
+  * @struct CliRequest
+  * @brief One CLI line as it moves through the pipeline; slots are reused, so strings keep their capacity.
+  *
+  * The decode stage fills the request fields, the sequence stage the order
+  * ID and timestamp, and the match stage the result fields.
+  */
+ struct CliRequest
+ {
+     enum class Kind : std::uint8_t
+     {
+         Order, Cancel, CancelAll, CancelRange, CancelOwner, Modify, Time, Auction,
+         Uncross, Print, Trades, ExportBook, ExportTrades, Bench, Unknown, Exit
+     };
+ 
+     // Decode
+     Kind kind = Kind::Unknown;                  ///< Command
+     bool valid = false;                         ///< Required arguments parsed
+     bool echo = true;                           ///< Echo the line (false for the end-of-input marker)
+     std::string text;                           ///< Input line
+     std::string command;                        ///< Command word, reported if unknown
+     SymbolId symbol = 0;                        ///< Target symbol
+     const std::string *newSymbol = nullptr;     ///< Set on a symbol's first use, for the match stage to intern
+     Order order{0, OrderType::BUY, 0, 0, 0};    ///< Order fields; Cancel/Modify use id, CancelRange price..stopPrice
+     long argument = 0;                          ///< TIME's clock, CANCEL_OWNER's owner, BENCH's order count
+     bool on = false;                            ///< AUCTION ON
+ 
+     // Match
+     bool ok = false;                            ///< Cancel/modify found the order; uncross cleared
+     bool unknownSymbol = false;                 ///< Symbol has no book and the command needs one (output holds its name)
+     std::size_t affected = 0;                   ///< Orders canceled or expired
+     double clearing = 0.0;                      ///< Uncross price
+     std::string output;                         ///< Text rendered by the match stage (book, trades, bench, exports)
+ };
+ 
+ /**
+  * @struct PipelineConfig
+  * @brief Settings of a CliPipeline.
+  */
+ struct PipelineConfig
+ {
+     BookConfig book;                      ///< Config of every book
+     std::size_t capacity = 1024;          ///< Ring slots (rounded up to a power of two)
+     std::string journalPath;              ///< Append every sequenced line here; empty disables journaling
+     bool pinThreads = false;              ///< Pin the sequence, match and encode threads (Linux only)
+     unsigned firstCore = 0;               ///< Core of the sequence stage; match and encode follow
+     bool autoExport = false;              ///< Auto-export setting of every book
+     std::string exportDir = "exports";    ///< Export root (one subdirectory per symbol)
+ };
+ 
+ /**
+  * @class CliPipeline
+  * @brief Runs CLI scripts through the staged pipeline.
+  *
+  * The journal is itself a valid input script: replaying it rebuilds the
+  * same books, since IDs and timestamps are assigned from the line order.
+  */
+ class CliPipeline
+ {
+ public:
+     /// @brief Construct an idle pipeline.
+     explicit CliPipeline(const PipelineConfig &config = PipelineConfig{});
+ 
+     /**
+      * @brief Process @p in until EXIT or end of input.
+      *
+      * Starts the stage threads, decodes on the calling thread and returns
+      * once the last response has been written.
+      *
+      * @param in Command script.
+      * @param out Echoed lines and responses.
+      * @param err Unknown-command errors.
+      */
+     void run(std::istream &in, std::ostream &out, std::ostream &err);
+ 
+     /// @brief Books built by the last run (inspect only between runs).
+     BookManager &books() { return engine; }
+ 
+ private:
+     /// Stage indexes in the ring.
+     enum Stage : std::size_t { Decode, Sequence, Match, Encode, StageCount };
+ 
+     /// @brief Parse @p line into @p req.
+     void decode(const std::string &line, CliRequest &req);
+ 
+     /// @brief Assign IDs and timestamps to @p req.
+     void sequence(CliRequest &req);
+ 
+     /// @brief Apply @p req to its book and record the result.
+     void match(CliRequest &req);
+ 
+     /// @brief Write @p req's echo and response.
+     static void encode(const CliRequest &req, std::ostream &out, std::ostream &err);
+ 
+     /**
+      * @brief Run stage @p s over the ring until it has passed on the Exit request.
+      * @param handle Called for each request of each batch.
+      * @param afterBatch Called once per batch, after its requests.
+      */
+     template <typename Handle, typename AfterBatch>
+     void runStage(Stage s, Handle &&handle, AfterBatch &&afterBatch);
+ 
+     PipelineConfig config;                 ///< Settings
+     PriceScale scale;                      ///< Decimal price to ticks, for decoding
+     StageRing<CliRequest> ring;            ///< Requests in flight
+     SymbolTable symbols;                   ///< Decode-side symbol ids
+     BookManager engine;                    ///< Books (match stage only)
+     SymbolId defaultSymbol = 0;            ///< DEFAULT symbol
+     std::vector<int> nextIds;              ///< Next order ID per symbol (sequence stage only)
+     long timestamp = 1;                    ///< Priority clock (sequence stage only)
+     std::ofstream journal;                 ///< Sequenced lines (sequence stage only)
+ };
+ 
+ #endif // CLI_PIPELINE_H
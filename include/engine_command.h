@@ -0,0 +1,50 @@
+/**
+ * @file engine_command.h
+ * @brief Request record passed from submitting threads to a matching thread.
+ *
+ * The threaded engines queue EngineCommands instead of calling the books
+ * directly, so only the thread that owns a BookManager ever touches it.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef ENGINE_COMMAND_H
+ #define ENGINE_COMMAND_H
+ 
+ #include "book_manager.h"
+ #include "order.h"
+ #include <cstdint>
+ #include <string>
+ 
+ /**
+  * @struct EngineCommand
+  * @brief One request queued for a matching thread.
+  *
+  * Add carries the full order. Cancel and Modify reuse order.id, and Modify
+  * also order.quantity, order.price and order.timestamp. AdvanceTime reads
+  * order.timestamp. Intern carries the symbol name, owned by the submitting
+  * engine's symbol table.
+  */
+ struct EngineCommand
+ {
+     enum class Kind : std::uint8_t { Intern, Add, Cancel, Modify, AdvanceTime };
+ 
+     Kind kind = Kind::Add;                     ///< Request type
+     SymbolId symbol = 0;                       ///< Symbol id in the receiving BookManager
+     Order order{0, OrderType::BUY, 0, 0, 0};   ///< Order or request fields (see above)
+     const std::string *name = nullptr;         ///< Symbol name for Intern
+ };
+ 
+ /**
+  * @brief Apply @p cmd to @p books on the thread that owns them.
+  *
+  * Intern must arrive in the same order the symbols were interned upstream,
+  * so ids agree on both sides.
+  *
+  * @return false if an add names a symbol that was never interned, or a
+  *         cancel or modify found no such order or book.
+  */
+ bool applyCommand(BookManager &books, const EngineCommand &cmd);
+ 
+ #endif // ENGINE_COMMAND_H
@@ -0,0 +1,92 @@
+/**
+ * @file event_sink.h
+ * @brief Event sinks receiving the book's executions and order lifecycle events.
+ *
+ * A sink is the book's third template parameter and is called inline; it
+ * provides four members:
+ *
+ *     void onTrade(const Trade &trade);   // every execution, in order
+ *     void onAdd(const Order &order);     // an order starts resting in a price level
+ *     void onCancel(const Order &order);  // a resting order leaves without trading (cancel, expiry)
+ *     void onModify(const Order &order);  // a resting order is amended in place (keeps priority)
+ *
+ * A modify that loses priority is reported as onCancel followed by the
+ * re-entry (trades, then onAdd if it rests). Pending stop orders are not
+ * reported until they are elected and rest.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef EVENT_SINK_H
+ #define EVENT_SINK_H
+ 
+ #include "order.h"
+ #include "trade.h"
+ #include <functional>
+ #include <type_traits>
+ #include <utility>
+ #include <vector>
+ 
+ /**
+  * @class TradeLog
+  * @brief Default sink: keeps every trade in memory and ignores order events.
+  *
+  * Backs getTrades(), printTrades() and exportTradesCSV(). The history grows
+  * for the book's lifetime unless clear() is called.
+  */
+ class TradeLog
+ {
+ public:
+     void onTrade(const Trade &trade) { log.push_back(trade); }
+     void onAdd(const Order &) {}
+     void onCancel(const Order &) {}
+     void onModify(const Order &) {}
+ 
+     /// @brief Trades recorded so far, oldest first.
+     const std::vector<Trade> &trades() const { return log; }
+ 
+     /// @brief Drop the recorded history (and its memory).
+     void clear() { std::vector<Trade>().swap(log); }
+ 
+ private:
+     std::vector<Trade> log;  ///< Recorded trades
+ };
+ 
+ /**
+  * @struct NullSink
+  * @brief Discards every event; the calls compile away entirely.
+  */
+ struct NullSink
+ {
+     void onTrade(const Trade &) {}
+     void onAdd(const Order &) {}
+     void onCancel(const Order &) {}
+     void onModify(const Order &) {}
+ };
+ 
+ /**
+  * @struct CallbackSink
+  * @brief Forwards each event to a runtime-assigned callback; unset callbacks are skipped.
+  */
+ struct CallbackSink
+ {
+     std::function<void(const Trade &)> trade;   ///< Called for each execution
+     std::function<void(const Order &)> add;     ///< Called when an order rests
+     std::function<void(const Order &)> cancel;  ///< Called when a resting order is canceled or expires
+     std::function<void(const Order &)> modify;  ///< Called when a resting order is amended in place
+ 
+     void onTrade(const Trade &t) { if (trade) trade(t); }
+     void onAdd(const Order &o) { if (add) add(o); }
+     void onCancel(const Order &o) { if (cancel) cancel(o); }
+     void onModify(const Order &o) { if (modify) modify(o); }
+ };
+ 
+ /// @brief True if sink @p S keeps a trade history (has trades()).
+ template <typename S, typename = void>
+ struct HasTradeHistory : std::false_type {};
+ 
+ template <typename S>
+ struct HasTradeHistory<S, std::void_t<decltype(std::declval<const S &>().trades())>> : std::true_type {};
+ 
+ #endif // EVENT_SINK_H
@@ -0,0 +1,113 @@
+/**
+ * @file match_policy.h
+ * @brief Compile-time allocation policies deciding how an incoming order is shared out across a price level.
+ *
+ * A policy is a stateless type with one static member template:
+ *
+ *     template <typename Fill>
+ *     static int allocate(const OrderPool &pool, const PriceLevel &level, int qty, Fill &&fill);
+ *
+ * It hands out up to @p qty against the resting orders of @p level by calling
+ * fill(handle, quantity) for each allocation, and returns what it could not
+ * place. A fill may remove the order from the level, or move a refilled
+ * iceberg to its back, so policies re-read links after every call. The book
+ * takes the policy as a template parameter, so the chosen loop is inlined
+ * into the matching path with no runtime dispatch.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef MATCH_POLICY_H
+ #define MATCH_POLICY_H
+ 
+ #include "order_pool.h"
+ #include "price_ladder.h"
+ #include <algorithm>
+ #include <cstdint>
+ 
+ /**
+  * @struct FifoPolicy
+  * @brief Price-time priority: the oldest order at the level fills first.
+  */
+ struct FifoPolicy
+ {
+     template <typename Fill>
+     static int allocate(const OrderPool &pool, const PriceLevel &level, int qty, Fill &&fill)
+     {
+         while (qty > 0 && !level.orders.empty())
+         {
+             OrderHandle h = level.orders.head;
+             int q = std::min(qty, pool[h].order.quantity);
+             fill(h, q);
+             qty -= q;
+         }
+         return qty;
+     }
+ };
+ 
+ /**
+  * @struct ProRataPolicy
+  * @brief Allocation proportional to displayed size, with the rounding remainder filled FIFO.
+  *
+  * Each order receives floor(qty * size / level total) in a single pass over
+  * the level, using the level's cached displayed total; lots left over by
+  * rounding then go to orders in time priority.
+  */
+ struct ProRataPolicy
+ {
+     template <typename Fill>
+     static int allocate(const OrderPool &pool, const PriceLevel &level, int qty, Fill &&fill)
+     {
+         std::int64_t total = level.totalQty;
+         if (qty > 0 && total > 0)
+         {
+             // Visit only the orders present now; refilled icebergs are requeued behind them
+             OrderHandle h = level.orders.head;
+             int allocated = 0;
+             for (std::uint32_t n = level.orderCount; n > 0 && h != NullHandle; --n)
+             {
+                 OrderHandle next = pool[h].next;
+                 int size = pool[h].order.quantity;
+                 int q = static_cast<int>(std::min<std::int64_t>(size, std::int64_t{qty} * size / total));
+                 if (q > 0)
+                 {
+                     fill(h, q);
+                     allocated += q;
+                 }
+                 h = next;
+             }
+             qty -= allocated;
+         }
+         return FifoPolicy::allocate(pool, level, qty, fill);
+     }
+ };
+ 
+ /**
+  * @struct TopOrderPolicy
+  * @brief The level's top order fills first, then @p Rest allocates the remainder.
+  *
+  * The top order is the one that opened the level (PriceLevel::topOrder). It
+  * keeps that status only while it rests there untouched by a requeue; once it
+  * leaves, the level has no top order.
+  *
+  * @tparam Rest Policy for the quantity left after the top order (e.g. ProRataPolicy).
+  */
+ template <typename Rest>
+ struct TopOrderPolicy
+ {
+     template <typename Fill>
+     static int allocate(const OrderPool &pool, const PriceLevel &level, int qty, Fill &&fill)
+     {
+         OrderHandle top = level.topOrder;
+         if (qty > 0 && top != NullHandle)
+         {
+             int q = std::min(qty, pool[top].order.quantity);
+             fill(top, q);
+             qty -= q;
+         }
+         return Rest::allocate(pool, level, qty, fill);
+     }
+ };
+ 
+ #endif // MATCH_POLICY_H
@@ -0,0 +1,126 @@
+/**
+ * @file mpsc_sequencer.h
+ * @brief Lock-free multi-producer/single-consumer sequencer handing commands to one matching thread.
+ *
+ * Each publish claims the next global sequence number with one atomic
+ * fetch-add; that number both orders the command and picks its slot. The
+ * producer then writes the slot and marks it full, and the consumer takes
+ * slots strictly in sequence order. No producer ever waits on another
+ * producer's lock: contention is a single shared counter, and each slot sits
+ * on its own cache lines so neighbouring producers do not false-share.
+ *
+ * A slot's state word encodes whose turn it is: it equals s while the slot is
+ * free for sequence s, and s + 1 once sequence s has been written. Consuming
+ * sequence s frees the slot for s + capacity.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef MPSC_SEQUENCER_H
+ #define MPSC_SEQUENCER_H
+ 
+ #include "cache_line.h"
+ #include <atomic>
+ #include <cstddef>
+ #include <cstdint>
+ #include <memory>
+ #include <thread>
+ #include <utility>
+ 
+ /**
+  * @class MpscSequencer
+  * @brief Bounded, sequence-numbering FIFO from any number of producers to one consumer.
+  *
+  * Sequence numbers start at 0 and have no gaps. A producer that has claimed a
+  * number but not yet written its slot holds back later sequences until it
+  * does, which is what keeps delivery in sequence order.
+  *
+  * @tparam T Default-constructible, move-assignable element type.
+  */
+ template <typename T>
+ class MpscSequencer
+ {
+ public:
+     /**
+      * @brief Construct an empty sequencer.
+      * @param capacity Minimum number of slots; rounded up to a power of two.
+      */
+     explicit MpscSequencer(std::size_t capacity)
+     {
+         std::size_t size = 2;
+         while (size < capacity)
+             size <<= 1;
+         slots = std::make_unique<Slot[]>(size);
+         for (std::size_t i = 0; i < size; ++i)
+             slots[i].state.store(i, std::memory_order_relaxed);
+         mask = size - 1;
+     }
+ 
+     MpscSequencer(const MpscSequencer &) = delete;
+     MpscSequencer &operator=(const MpscSequencer &) = delete;
+ 
+     /// @brief Number of slots.
+     std::size_t capacity() const { return mask + 1; }
+ 
+     /**
+      * @brief Sequence @p value and queue it (any thread).
+      *
+      * Waits only while the ring is full, i.e. while the consumer has not yet
+      * taken the command published capacity() sequences earlier.
+      *
+      * @return The sequence number assigned to @p value.
+      */
+     std::uint64_t publish(T &&value)
+     {
+         std::uint64_t seq = next.value.fetch_add(1, std::memory_order_relaxed);
+         Slot &slot = slots[seq & mask];
+         while (slot.state.load(std::memory_order_acquire) != seq)
+             std::this_thread::yield();
+         slot.value = std::move(value);
+         slot.state.store(seq + 1, std::memory_order_release);
+         return seq;
+     }
+ 
+     /**
+      * @brief Take the next command in sequence order (consumer thread only).
+      * @param out Receives the command.
+      * @param seq Receives its sequence number.
+      * @return false if the next sequence has not been published yet.
+      */
+     bool tryConsume(T &out, std::uint64_t &seq)
+     {
+         Slot &slot = slots[head & mask];
+         if (slot.state.load(std::memory_order_acquire) != head + 1)
+             return false;
+         out = std::move(slot.value);
+         seq = head;
+         slot.state.store(head + capacity(), std::memory_order_release);
+         ++head;
+         return true;
+     }
+ 
+     /// @brief Number of sequence numbers claimed so far (any thread).
+     std::uint64_t claimed() const { return next.value.load(std::memory_order_acquire); }
+ 
+ private:
+     /// @brief One command and its turn word, padded to whole cache lines.
+     struct alignas(CacheLine) Slot
+     {
+         std::atomic<std::uint64_t> state{0};  ///< Free for s when == s, written when == s + 1
+         T value{};                            ///< Queued command
+     };
+ 
+     /// @brief Producer counter on its own cache line.
+     struct alignas(CacheLine) PaddedCounter
+     {
+         std::atomic<std::uint64_t> value{0};
+     };
+ 
+     std::unique_ptr<Slot[]> slots;                  ///< Slot storage (power-of-two count)
+     std::size_t mask = 0;                           ///< capacity() - 1
+     PaddedCounter next;                             ///< Next sequence number to claim (producers)
+     alignas(CacheLine) std::uint64_t head = 0;      ///< Next sequence to consume (consumer only)
+ };
+ 
+ #endif // MPSC_SEQUENCER_H
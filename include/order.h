@@ -15,6 +15,7 @@
  #ifndef ORDER_H
  #define ORDER_H
  
+ #include "price.h"
  #include <string>
  
  /**
@@ -27,9 +28,27 @@
      SELL   ///< Sell order (ask)
  };
  
+ /**
+  * @enum OrderKind
+  * @brief Time-in-force / execution style of an order.
+  *
+  * Only LIMIT orders can rest in the book. The taker kinds trade against the
+  * opposite side on arrival and any unfilled remainder is discarded. Stop
+  * kinds wait outside the visible book until a trade elects them.
+  */
+ enum class OrderKind
+ {
+     LIMIT,       ///< Trade what crosses, rest the remainder
+     MARKET,      ///< Trade at any price, discard the remainder (price is ignored)
+     IOC,         ///< Immediate-or-cancel: trade up to the limit, discard the remainder
+     FOK,         ///< Fill-or-kill: trade the full quantity up to the limit, or nothing
+     STOP,        ///< Held until the last trade reaches stopPrice, then released as MARKET
+     STOP_LIMIT   ///< Held until the last trade reaches stopPrice, then released as LIMIT at price
+ };
+ 
  /**
   * @struct Order
-  * @brief Represents a single limit order.
+  * @brief Represents a single order (limit unless its kind says otherwise).
   *
   * Each order has:
   *  - A unique ID (for tracking and modification)
@@ -37,24 +56,37 @@
   *  - A limit price
   *  - A quantity to trade
   *  - A timestamp (used for price-time priority)
+  *  - An order kind (LIMIT unless stated otherwise)
+  *
+  * A resting LIMIT order with 0 < displayQty < quantity is an iceberg: only
+  * displayQty is shown in `quantity`, the rest is held in `hiddenQty` and
+  * replenishes the visible slice each time it fills.
   */
  struct Order
  {
      int id;            ///< Unique order identifier
      OrderType type;    ///< BUY or SELL
-     double price;      ///< Limit price
+     Price price;       ///< Limit price in ticks
      int quantity;      ///< Quantity remaining in the order
      long timestamp;    ///< Timestamp for FIFO priority at the same price
+     OrderKind kind;    ///< LIMIT, MARKET, IOC, FOK, STOP or STOP_LIMIT
+     int displayQty = 0;    ///< Iceberg slice size; 0 displays the whole quantity
+     int hiddenQty = 0;     ///< Iceberg reserve behind the visible slice (maintained by the book)
+     Price stopPrice = 0;   ///< Trigger price in ticks for STOP / STOP_LIMIT
+     long expireAt = 0;     ///< Good-till-time expiry (same clock as timestamp); 0 = good till canceled
+     int owner = 0;         ///< Submitting participant, for cancelByOwner; 0 = none
  
      /**
       * @brief Construct a new Order.
       * @param id Unique order ID.
       * @param type Side of the order (BUY/SELL).
-      * @param price Limit price.
+      * @param price Limit price in ticks.
       * @param quantity Order quantity.
       * @param timestamp Time the order was placed.
+      * @param kind Execution style (defaults to a resting limit order).
       */
-     Order(int id, OrderType type, double price, int quantity, long timestamp);
+     Order(int id, OrderType type, Price price, int quantity, long timestamp,
+           OrderKind kind = OrderKind::LIMIT);
  };
  
  #endif // ORDER_H
@@ -11,47 +11,133 @@
  * @date
  *   2025-08-08
  */
-
+ 
  #ifndef ORDER_BOOK_H
  #define ORDER_BOOK_H
  
  #include "order.h"
  #include "trade.h"
+ #include "book_config.h"
+ #include "price.h"
+ #include "price_ladder.h"
+ #include "order_pool.h"
+ #include "order_id_map.h"
+ #include "order_index.h"
+ #include "timer_wheel.h"
+ #include "top_of_book.h"
+ #include "match_policy.h"
+ #include "event_sink.h"
+ #include <cstdint>
+ #include <iostream>
  #include <map>
+ #include <optional>
  #include <queue>
  #include <vector>
- #include <unordered_map>
  #include <string>
- #include <list>
  
  /**
-  * @class OrderBook
-  * @brief Maintains bid/ask lists, matches trades, and tracks executed orders.
+  * @struct LevelInfo
+  * @brief Read-only aggregate view of one price level.
+  */
+ struct LevelInfo
+ {
+     Price price;            ///< Level price in ticks
+     std::int64_t quantity;  ///< Displayed resting quantity at the level
+     std::uint32_t orders;   ///< Number of resting orders at the level
+     std::int64_t total;     ///< Displayed plus hidden iceberg quantity
+ };
+ 
+ /**
+  * @class BasicOrderBook
+  * @brief Maintains bid/ask price ladders, matches trades, and tracks executed orders.
   *
-  * Orders are stored in FIFO order per price level using std::list.
-  * The engine matches based on price-time priority:
+  * Each side is a ladder of price levels, best price first, and each level keeps
+  * its orders in an intrusive FIFO of nodes taken from an OrderPool, so resting
+  * orders are not individually heap-allocated. The ladder type selects the backend:
+  *  - MapLadder (OrderBook): any price, O(log levels) insert
+  *  - DenseLadder (DenseOrderBook): bounded price band, O(1) insert and best price
+  *
+  * The engine matches based on price priority:
   *  - Highest bid matches lowest ask
   *  - If prices cross, trades are executed
   *  - Partial fills are supported
+  *
+  * Within a price level, the Policy decides how an incoming order is shared
+  * across resting orders (FifoPolicy, ProRataPolicy, TopOrderPolicy<...>).
+  * Auction uncross and manual matchOrders() always pair in time priority.
+  *
+  * Executions and order lifecycle events go to the Sink. The default
+  * TradeLog keeps the trade history behind getTrades(); NullSink keeps
+  * nothing and CallbackSink forwards to user callbacks.
+  *
+  * With a SeqlockTopOfBook attached (setTopOfBookFeed), the book publishes
+  * its BBO and last trade once at the end of every public mutation, so other
+  * threads can watch the top without touching the book.
+  *
+  * @tparam Ladder Price ladder template, instantiated once per side.
+  * @tparam Policy Level allocation policy (see match_policy.h).
+  * @tparam Sink Event sink (see event_sink.h).
   */
- class OrderBook
+ template <template <OrderType> class Ladder, typename Policy = FifoPolicy, typename Sink = TradeLog>
+ class BasicOrderBook
  {
  public:
+     /**
+      * @brief Construct an empty book.
+      * @param config Instrument settings (tick size, price band for DenseLadder, ID index mode).
+      */
+     explicit BasicOrderBook(const BookConfig &config = BookConfig{});
+ 
      /**
       * @brief Add an order to the book and attempt to match it immediately.
+      *
+      * LIMIT orders rest any unfilled remainder (as an iceberg if displayQty is
+      * set and smaller than the remainder). MARKET, IOC and FOK orders
+      * only take liquidity: they never enter the ladders or the order index,
+      * and whatever does not fill on arrival is discarded. STOP and STOP_LIMIT
+      * orders wait in a trigger index (cancelable by ID) until a trade prints
+      * at or through their stopPrice. A non-zero expireAt makes a resting or
+      * pending order good-till-time (see advanceTime); orders whose expiry is
+      * not after the book's current time are rejected.
+      *
       * @param order The order to insert.
       */
      void addOrder(const Order &order);
  
+     /**
+      * @brief Add a packet of orders, in order.
+      *
+      * Produces exactly the trades and resting state of calling addOrder on
+      * each element in turn. The batch prefetches the index slots of orders a
+      * few positions ahead, and their price levels too on a DenseLadder (a
+      * MapLadder has no way to prefetch a level, so it gets the index half
+      * only). Matching and level bookkeeping still run per order; the only
+      * deferred work is auto-export (if enabled), run once at the end rather
+      * than after every trade.
+      *
+      * @param orders First order of the packet.
+      * @param count Number of orders.
+      */
+     void addOrders(const Order *orders, std::size_t count);
+ 
+     /// @brief Add every order in @p orders, in order (see addOrders(const Order *, std::size_t)).
+     void addOrders(const std::vector<Order> &orders) { addOrders(orders.data(), orders.size()); }
+ 
      /**
       * @brief Modify an existing order's quantity and price.
+      *
+      * Reducing quantity at an unchanged price updates the order in place and
+      * keeps its time priority (newTimestamp is ignored). Any price change or
+      * size increase moves the order to the back of its new level. For an
+      * iceberg, quantities are displayed plus hidden and the slice size is kept.
+      *
       * @param id Order ID to modify.
       * @param newQty New quantity.
-      * @param newPrice New price.
+      * @param newPrice New price in ticks.
       * @param newTimestamp New timestamp for time-priority updates.
       * @return true if the order was found and modified, false otherwise.
       */
-     bool modifyOrder(int id, int newQty, double newPrice, long newTimestamp);
+     bool modifyOrder(int id, int newQty, Price newPrice, long newTimestamp);
  
      /**
       * @brief Cancel an existing order by ID.
@@ -60,37 +146,290 @@
       */
      bool cancelOrder(int id);
  
+     /**
+      * @brief Cancel a packet of order IDs, in order.
+      *
+      * Equivalent to calling cancelOrder on each ID. Index slots and order
+      * nodes for later IDs are prefetched while earlier ones are processed;
+      * price levels are not, and level updates run per cancel as usual.
+      *
+      * @param ids First ID of the packet.
+      * @param count Number of IDs.
+      * @return Number of orders actually canceled.
+      */
+     std::size_t cancelOrders(const int *ids, std::size_t count);
+ 
+     /// @brief Cancel every ID in @p ids, in order (see cancelOrders(const int *, std::size_t)).
+     std::size_t cancelOrders(const std::vector<int> &ids) { return cancelOrders(ids.data(), ids.size()); }
+ 
+     /**
+      * @brief Cancel every resting order on @p side.
+      *
+      * Whole price levels are dropped at once and each level's orders go back
+      * to the pool in a single splice; only the per-order index, expiry and
+      * owner entries are touched individually. Pending stop orders are kept.
+      *
+      * @param side Side to clear.
+      * @return Number of orders canceled.
+      */
+     std::size_t cancelAll(OrderType side);
+ 
+     /**
+      * @brief Cancel every resting order on @p side priced within [@p lo, @p hi] (see cancelAll()).
+      * @param side Side to cancel on.
+      * @param lo Lowest price canceled, in ticks.
+      * @param hi Highest price canceled, in ticks.
+      * @return Number of orders canceled.
+      */
+     std::size_t cancelRange(OrderType side, Price lo, Price hi);
+ 
+     /**
+      * @brief Cancel every order, resting or pending stop, submitted by @p owner.
+      *
+      * Follows the owner's intrusive chain, so the cost depends only on that
+      * owner's order count (cancel-on-disconnect).
+      *
+      * @param owner Order::owner to cancel for (0 cancels nothing).
+      * @return Number of orders canceled.
+      */
+     std::size_t cancelByOwner(int owner);
+ 
      /**
       * @brief Attempt to match the top of the book (highest bid vs lowest ask).
       *
-      * Called internally after adds/modifications, but can also be invoked manually.
+      * addOrder matches incoming orders itself, so the book never rests crossed
+      * through the normal API; this remains available for manual invocation.
       */
      void matchOrders();
  
      /**
-      * @brief Print the current order book to stdout.
+      * @brief Enter or leave call-auction mode.
+      *
+      * While in auction, limit orders rest without matching (the book may be
+      * crossed) and taker kinds are rejected. Leaving auction mode runs
+      * uncross() so continuous trading resumes from an uncrossed book.
+      *
+      * @param on True to start accumulating, false to resume continuous matching.
       */
-     void printBook() const;
+     void setAuctionMode(bool on);
+ 
+     /// @brief True while orders are being accumulated for an auction.
+     bool inAuction() const { return auction; }
  
      /**
-      * @brief Print the trade history to stdout.
+      * @brief Advance the book's clock, removing every order whose expireAt has been reached.
+      *
+      * Expired orders leave their level (or stop trigger) and the order index
+      * in O(1) each, in expiry-time order. A time before currentTime() is
+      * ignored.
+      *
+      * @param now New time, on the same clock as order timestamps.
+      * @return Number of orders expired.
+      */
+     std::size_t advanceTime(long now);
+ 
+     /**
+      * @brief Move the expiry clock of a book with no GTT orders to @p now, without counting an event.
+      *
+      * For a new book joining a clock that has already moved (see BookManager).
+      * A time before currentTime() is ignored.
+      *
+      * @param now New time, on the same clock as order timestamps.
+      */
+     void startClockAt(long now);
+ 
+     /// @brief Current time of the book's expiry clock (last value passed to advanceTime).
+     long currentTime() const { return expiries.now(); }
+ 
+     /// @brief Price of the most recent trade, or std::nullopt before the first one.
+     std::optional<Price> lastTradePrice() const { return lastPrice; }
+ 
+     /**
+      * @brief Price the book would uncross at right now, without trading.
+      * @return Clearing price in ticks, or std::nullopt if the book is not crossed.
       */
-     void printTrades() const;
+     std::optional<Price> indicativePrice() const;
+ 
+     /**
+      * @brief Execute the auction: fill all crossed interest at a single clearing price.
+      *
+      * The price maximizes executable volume, then minimizes the unmatched
+      * surplus; any remaining tie goes to the middle of the tied prices. It is
+      * found in one sweep over the crossed levels' cached totals. Orders then
+      * fill in price-time priority, every trade printing at the clearing price.
+      *
+      * @return The clearing price, or std::nullopt if nothing crossed.
+      */
+     std::optional<Price> uncross();
+ 
+     /**
+      * @brief Best (highest) bid price.
+      * @return Price in ticks, or std::nullopt if there are no bids.
+      */
+     std::optional<Price> bestBid() const
+     {
+         const PriceLevel *level = bids.best();
+         return level ? std::optional<Price>(level->price) : std::nullopt;
+     }
+ 
+     /**
+      * @brief Best (lowest) ask price.
+      * @return Price in ticks, or std::nullopt if there are no asks.
+      */
+     std::optional<Price> bestAsk() const
+     {
+         const PriceLevel *level = asks.best();
+         return level ? std::optional<Price>(level->price) : std::nullopt;
+     }
+ 
+     /// @brief Total quantity resting at the best bid (0 if no bids).
+     std::int64_t bestBidQty() const
+     {
+         const PriceLevel *level = bids.best();
+         return level ? level->totalQty : 0;
+     }
+ 
+     /// @brief Total quantity resting at the best ask (0 if no asks).
+     std::int64_t bestAskQty() const
+     {
+         const PriceLevel *level = asks.best();
+         return level ? level->totalQty : 0;
+     }
+ 
+     /**
+      * @brief Book events applied so far.
+      *
+      * Every call to a public mutator counts as one event, whether or not it
+      * changed the book (a rejected order or a cancel of an unknown ID still
+      * counts); addOrders and cancelOrders count one per element. Snapshots
+      * carry it so readers can place them in the book's event stream.
+      */
+     std::uint64_t sequence() const { return events; }
+ 
+     /// @brief Best levels, last trade and event sequence as one snapshot.
+     TopOfBook topOfBook() const
+     {
+         const PriceLevel *bid = bids.best();
+         const PriceLevel *ask = asks.best();
+         TopOfBook top;
+         if (bid)
+         {
+             top.bidPrice = bid->price;
+             top.bidQty = bid->totalQty;
+         }
+         if (ask)
+         {
+             top.askPrice = ask->price;
+             top.askQty = ask->totalQty;
+         }
+         top.lastPrice = lastPrice.value_or(0);
+         top.lastQty = lastQty;
+         top.lastTime = lastTradeTime;
+         top.sequence = events;
+         return top;
+     }
+ 
+     /**
+      * @brief Publish topOfBook() to @p feed after every mutation from now on.
+      *
+      * Publishes the current state immediately, then once per event, stamped
+      * with sequence(). The book writes to @p feed from whichever thread
+      * mutates it; @p feed must outlive the attachment and should not be fed
+      * by two books at once.
+      *
+      * @param feed Target, or nullptr to stop publishing.
+      */
+     void setTopOfBookFeed(SeqlockTopOfBook *feed)
+     {
+         topFeed = feed;
+         if (topFeed)
+             topFeed->publish(topOfBook());
+     }
+ 
+     /**
+      * @brief Best ask minus best bid.
+      * @return Spread in ticks, or std::nullopt unless both sides are populated.
+      */
+     std::optional<Price> spread() const
+     {
+         const PriceLevel *bid = bids.best();
+         const PriceLevel *ask = asks.best();
+         if (!bid || !ask)
+             return std::nullopt;
+         return ask->price - bid->price;
+     }
  
      /**
-      * @brief Export trades to CSV.
+      * @brief Midpoint of best bid and best ask.
+      * @return Mid in ticks (may fall on a half tick), or std::nullopt unless both sides are populated.
+      */
+     std::optional<double> mid() const
+     {
+         const PriceLevel *bid = bids.best();
+         const PriceLevel *ask = asks.best();
+         if (!bid || !ask)
+             return std::nullopt;
+         return (static_cast<double>(bid->price) + static_cast<double>(ask->price)) / 2.0;
+     }
+ 
+     /**
+      * @brief Aggregate quantity and order count resting at one price.
+      * @param side BUY for the bid ladder, SELL for the ask ladder.
+      * @param price Level price in ticks.
+      * @return The level's aggregates, or std::nullopt if no order rests there.
+      */
+     std::optional<LevelInfo> getLevel(OrderType side, Price price) const;
+ 
+     /**
+      * @brief Visit the best @p n levels of one side, best price first.
+      *
+      * Reads cached per-level aggregates, so the cost is O(levels visited)
+      * regardless of how many orders rest in those levels.
+      *
+      * @param side BUY for bids, SELL for asks.
+      * @param n Maximum number of levels to visit.
+      * @param fn Callable invoked as fn(const LevelInfo &).
+      */
+     template <typename Fn>
+     void forEachLevel(OrderType side, std::size_t n, Fn &&fn) const
+     {
+         auto visit = [&fn](const PriceLevel &level) {
+             fn(LevelInfo{level.price, level.totalQty, level.orderCount, level.totalQty + level.hiddenQty});
+         };
+         if (side == OrderType::BUY)
+             bids.forEach(visit, n);
+         else
+             asks.forEach(visit, n);
+     }
+ 
+     /**
+      * @brief Print the current order book.
+      * @param out Destination stream (stdout by default).
+      */
+     void printBook(std::ostream &out = std::cout) const;
+ 
+     /**
+      * @brief Print the trade history (requires a sink with history).
+      * @param out Destination stream (stdout by default).
+      */
+     void printTrades(std::ostream &out = std::cout) const;
+ 
+     /**
+      * @brief Export trades to CSV (requires a sink with history).
       * @param baseName Output filename prefix (timestamp and sequence appended automatically).
+      * @param log Stream receiving the "exported to" confirmation.
       */
-     void exportTradesCSV(const std::string &baseName = "trades") const;
+     void exportTradesCSV(const std::string &baseName = "trades", std::ostream &log = std::cout) const;
  
      /**
       * @brief Export current order book snapshot to CSV.
       * @param baseName Output filename prefix.
+      * @param log Stream receiving the "exported to" confirmation.
       */
-     void exportBookCSV(const std::string &baseName = "book") const;
+     void exportBookCSV(const std::string &baseName = "book", std::ostream &log = std::cout) const;
  
      /**
-      * @brief Set the directory for CSV exports.
+      * @brief Set the directory for CSV exports (created on the first export).
       * @param dir Target directory.
       */
      void setExportDir(const std::string &dir);
@@ -103,38 +442,250 @@
  
      /**
       * @brief Accessor for executed trades.
+      *
+      * Only available when the Sink keeps a trade history (TradeLog).
+      *
       * @return Const reference to the vector of trades.
       */
-     const std::vector<Trade> &getTrades() const { return trades; }
+     template <typename S = Sink>
+     const std::vector<Trade> &getTrades() const { return sink.trades(); }
+ 
+     /// @brief Number of trades executed, whatever the Sink keeps.
+     std::uint64_t getTradeCount() const { return tradeCount; }
+ 
+     /// @brief The book's event sink (e.g. to set callbacks or clear a TradeLog).
+     Sink &eventSink() { return sink; }
+ 
+     /// @copydoc eventSink()
+     const Sink &eventSink() const { return sink; }
  
- private:
      /**
-      * @brief Internal mapping from order ID to its list iterator for O(1) lookup.
+      * @brief Convert a decimal price to this book's ticks (for parsing at the edge).
+      * @param price Decimal price.
+      * @return Nearest tick count.
       */
-     struct IdInfo
-     {
-         OrderType type;                  ///< Order side (BUY/SELL)
-         std::list<Order>::iterator it;   ///< Iterator to order in the list
-     };
+     Price toTicks(double price) const { return scale.toTicks(price); }
+ 
+     /**
+      * @brief Convert ticks back to a decimal price (for display and export).
+      * @param ticks Price in ticks.
+      * @return Decimal price.
+      */
+     double toPrice(Price ticks) const { return scale.toDouble(ticks); }
+ 
+     /**
+      * @brief Pre-size order storage so the first @p orders resting orders never allocate.
+      * @param orders Expected peak number of resting orders.
+      */
+     void reserve(std::size_t orders);
+ 
+ private:
+     PriceScale scale;                    ///< Tick size used at the parsing/export edges
+     Ladder<OrderType::BUY> bids;         ///< Bid levels (price desc, FIFO per price)
+     Ladder<OrderType::SELL> asks;        ///< Ask levels (price asc, FIFO per price)
  
-     std::list<Order> bids;               ///< Buy orders (sorted by price desc, FIFO per price)
-     std::list<Order> asks;               ///< Sell orders (sorted by price asc, FIFO per price)
+     OrderPool pool;                      ///< Storage for resting orders
+     OrderIndex orderIndex;               ///< Order ID -> pool handle, for cancel/modify
+     OrderIdMap<OrderHandle> owners;      ///< Owner -> newest order in its chain (OrderNode::ownerNext)
  
-     std::unordered_map<int, IdInfo> orderIndex; ///< Fast lookup for cancel/modify
+     // Trigger indexes for pending stops, nearest trigger first on each side
+     MapLadder<OrderType::SELL> buyStops; ///< Buy stops by stopPrice, ascending (elected as price rises)
+     MapLadder<OrderType::BUY> sellStops; ///< Sell stops by stopPrice, descending (elected as price falls)
+     OrderQueue electedStops;             ///< Triggered stops awaiting release, in election order
+     TimerWheel expiries;                 ///< Good-till-time schedule of resting and pending orders
+     std::optional<Price> lastPrice;      ///< Price of the most recent trade
+     int lastQty = 0;                     ///< Quantity of the most recent trade
+     long lastTradeTime = 0;              ///< Timestamp of the most recent trade
+     bool releasingStops = false;         ///< Guards releaseStops against re-entry
+ 
+     static constexpr std::size_t PrefetchDistance = 8; ///< Batch look-ahead, in messages
  
      int totalVolumeTraded = 0;           ///< Cumulative traded quantity
-     std::vector<Trade> trades;           ///< Executed trades
+     std::uint64_t tradeCount = 0;        ///< Executions so far
+     Sink sink;                           ///< Receives executions and order events
+     std::uint64_t events = 0;            ///< Public mutations applied (see sequence())
+     SeqlockTopOfBook *topFeed = nullptr; ///< Top-of-book publication target, if any
+ 
+     /// @brief End of a public mutation: count @p count events and publish the top of book, if attached.
+     void finishEvent(std::uint64_t count = 1)
+     {
+         events += count;
+         if (topFeed)
+             topFeed->publish(topOfBook());
+     }
+ 
+     /// @brief Auto-export after trades: the trade history (if the Sink keeps one) and a book snapshot.
+     void exportAfterTrades() const;
  
      /**
       * @brief Execute a trade between two orders.
       * @param buy Reference to the buy order.
       * @param sell Reference to the sell order.
+      * @param px Execution price in ticks.
+      * @param qty Quantity to trade (at most either order's remaining quantity).
+      */
+     void executeTrade(Order &buy, Order &sell, Price px, int qty);
+ 
+     /// @brief The other side of the book.
+     static constexpr OrderType opposite(OrderType side)
+     {
+         return side == OrderType::BUY ? OrderType::SELL : OrderType::BUY;
+     }
+ 
+     /// @brief True if a @p Side order limited at @p limit trades against a resting price @p resting.
+     template <OrderType Side>
+     static constexpr bool crosses(Price limit, Price resting)
+     {
+         if constexpr (Side == OrderType::BUY)
+             return limit >= resting;
+         else
+             return limit <= resting;
+     }
+ 
+     /// @brief Resting levels of @p Side, chosen at compile time.
+     template <OrderType Side>
+     Ladder<Side> &ladder()
+     {
+         if constexpr (Side == OrderType::BUY)
+             return bids;
+         else
+             return asks;
+     }
+ 
+     /// @copydoc ladder()
+     template <OrderType Side>
+     const Ladder<Side> &ladder() const
+     {
+         if constexpr (Side == OrderType::BUY)
+             return bids;
+         else
+             return asks;
+     }
+ 
+     /// @brief Stop trigger index of @p Side, chosen at compile time.
+     template <OrderType Side>
+     MapLadder<opposite(Side)> &stops()
+     {
+         if constexpr (Side == OrderType::BUY)
+             return buyStops;
+         else
+             return sellStops;
+     }
+ 
+     /**
+      * @brief Handle a MARKET, IOC or FOK order: trade what is available, discard the rest.
+      * @param order The taker order (never rests).
       */
-     void executeTrade(Order &buy, Order &sell);
+     template <OrderType Side>
+     void executeTaker(const Order &order);
+ 
+     /**
+      * @brief True if the opposite side holds at least @p order's quantity at prices it crosses.
+      *
+      * Walks the opposite levels best-first using their cached totals and
+      * stops as soon as the quantity is covered or prices stop crossing.
+      */
+     template <OrderType Side>
+     bool canFill(const Order &order) const;
+ 
+     /**
+      * @brief Compute the auction clearing price over the crossed levels.
+      * @param volume Set to the quantity that would execute (0 if not crossed).
+      */
+     std::optional<Price> clearingPrice(std::int64_t &volume) const;
+ 
+     /// @brief addOrder without the event accounting that follows it.
+     void submitOrder(const Order &order);
+ 
+     /// @brief addOrder without the stop release that follows it.
+     void placeOrder(const Order &order);
+ 
+     /// @brief Band-check, match and rest a validated LIMIT order on @p Side.
+     template <OrderType Side>
+     void placeLimit(const Order &order);
+ 
+     /// @brief Remove pooled order @p h from its level (or stop trigger), the index and the expiry wheel.
+     void removeOrder(OrderHandle h);
+ 
+     /// @brief Hold a STOP / STOP_LIMIT order in its side's trigger index.
+     template <OrderType Side>
+     void parkStop(const Order &order);
+ 
+     /// @brief Cancel @p Side's resting orders priced in [@p lo, @p hi], a level at a time.
+     template <OrderType Side>
+     std::size_t cancelLevels(Price lo, Price hi);
+ 
+     /// @brief Cancel every order in @p level and return their nodes to the pool; the level is left empty.
+     std::size_t purgeLevel(PriceLevel &level);
+ 
+     /// @brief Push pooled order @p h onto its owner's chain (no-op for owner 0).
+     void linkOwner(OrderHandle h);
+ 
+     /// @brief Remove pooled order @p h from its owner's chain (no-op for owner 0).
+     void unlinkOwner(OrderHandle h);
+ 
+     /// @brief Erase the now-empty @p level from @p Side's price ladder, or its stop index if @p isStop.
+     template <OrderType Side>
+     void eraseLevel(PriceLevel &level, bool isStop);
  
+     /**
+      * @brief Move stops whose trigger the last trade reached into the elected queue.
+      *
+      * Each trigger index is sorted nearest-trigger-first, so only the front
+      * range the price just crossed is visited. Buy stops are elected before
+      * sell stops, lowest (resp. highest) trigger first, FIFO within a trigger.
+      */
+     void electStops();
+ 
+     /**
+      * @brief Release elected stops into matching, one at a time, until none remain.
+      *
+      * Trades caused by a released stop can elect further stops; they queue
+      * behind those already elected. Does nothing during an auction.
+      */
+     void releaseStops();
+ 
+     /**
+      * @brief Trade a marketable, not-yet-resting order against the opposite side.
+      *
+      * Consumes opposite levels best-first, allocating within each level by
+      * Policy, until the order is filled or no longer crosses. @p incoming
+      * keeps any residual.
+      *
+      * @tparam Side Side of @p incoming; fixes the opposite ladder, the cross
+      *              test and the buyer/seller roles at compile time.
+      */
+     template <OrderType Side>
+     void matchIncoming(Order &incoming);
+ 
+     /// @brief Append pooled order @p h to @p level, updating the level aggregates.
+     void linkOrder(PriceLevel &level, OrderHandle h);
+ 
+     /// @brief Remove pooled order @p h from its level, updating the level aggregates.
+     void unlinkOrder(PriceLevel &level, OrderHandle h);
+ 
+     /**
+      * @brief Handle a resting order whose displayed quantity just reached zero.
+      *
+      * An iceberg with reserve left is refilled in place and moved to the back
+      * of @p level (same node, same index entry). Anything else is removed from
+      * the index, unlinked and returned to the pool.
+      */
+     void retireFilled(PriceLevel &level, OrderHandle h);
+ 
+     bool auction = false;                ///< Accumulating orders for uncross()
      bool autoExport = true;              ///< If true, export after each trade
      std::string exportDir = "exports";   ///< Directory for export files
  };
  
+ /// Default book: tree-based ladder accepting any price.
+ using OrderBook = BasicOrderBook<MapLadder>;
+ 
+ /// Banded book: tick-indexed ladder for instruments trading inside a fixed price band.
+ using DenseOrderBook = BasicOrderBook<DenseLadder>;
+ 
+ /// Pro-rata book: incoming orders are shared across a level by displayed size.
+ using ProRataOrderBook = BasicOrderBook<MapLadder, ProRataPolicy>;
+ 
  #endif // ORDER_BOOK_H
  
\ No newline at end of file
@@ -0,0 +1,211 @@
+/**
+ * @file order_id_map.h
+ * @brief Open-addressing hash map keyed by integer order ID.
+ *
+ * Replaces std::unordered_map for the order index: entries are stored inline
+ * in one power-of-two slot array (no node allocation per entry), lookups use
+ * linear probing from a multiplicative hash, and erase uses backward-shift
+ * deletion so no tombstones accumulate under heavy cancel traffic.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef ORDER_ID_MAP_H
+ #define ORDER_ID_MAP_H
+ 
+ #include "prefetch.h"
+ #include <cstddef>
+ #include <cstdint>
+ #include <limits>
+ #include <vector>
+ 
+ /**
+  * @class OrderIdMap
+  * @brief Flat int -> Value map with linear probing and tombstone-free erase.
+  *
+  * The table is kept at most half full. INT_MIN is used internally as the
+  * empty-slot marker, so an entry with that key is held in a dedicated side
+  * slot instead of the table.
+  *
+  * @tparam Value Trivially copyable mapped type (e.g. an OrderHandle).
+  */
+ template <typename Value>
+ class OrderIdMap
+ {
+ public:
+     /// @brief Number of entries.
+     std::size_t size() const { return count + (hasEmptyKey ? 1 : 0); }
+ 
+     bool empty() const { return size() == 0; }
+ 
+     /// @brief Entries that fit before the next rehash.
+     std::size_t capacity() const { return slots.size() / 2; }
+ 
+     /**
+      * @brief Size the table so @p entries fit without rehashing.
+      * @param entries Expected number of entries.
+      */
+     void reserve(std::size_t entries)
+     {
+         if (entries > capacity())
+             rehash(tableSizeFor(entries));
+     }
+ 
+     /// @brief Remove every entry, keeping the allocated table.
+     void clear()
+     {
+         for (auto &slot : slots)
+             slot.key = EmptyKey;
+         count = 0;
+         hasEmptyKey = false;
+     }
+ 
+     /**
+      * @brief Find the value mapped to @p key.
+      * @return Pointer to the value, or nullptr if absent (invalidated by insert/erase).
+      */
+     Value *find(int key)
+     {
+         if (key == EmptyKey)
+             return hasEmptyKey ? &emptyKeyValue : nullptr;
+         if (slots.empty())
+             return nullptr;
+         for (std::size_t i = home(key);; i = (i + 1) & mask)
+         {
+             Slot &slot = slots[i];
+             if (slot.key == key)
+                 return &slot.value;
+             if (slot.key == EmptyKey)
+                 return nullptr;
+         }
+     }
+ 
+     const Value *find(int key) const { return const_cast<OrderIdMap *>(this)->find(key); }
+ 
+     bool contains(int key) const { return find(key) != nullptr; }
+ 
+     /// @brief Hint that the home slot of @p key will be probed soon.
+     void prefetch(int key) const
+     {
+         if (!slots.empty())
+             prefetchRead(&slots[home(key)]);
+     }
+ 
+     /// @brief Insert @p key or overwrite its existing value.
+     void insert(int key, const Value &value)
+     {
+         if (key == EmptyKey)
+         {
+             hasEmptyKey = true;
+             emptyKeyValue = value;
+             return;
+         }
+         if ((count + 1) * 2 > slots.size())
+             rehash(slots.empty() ? MinSlots : slots.size() * 2);
+         for (std::size_t i = home(key);; i = (i + 1) & mask)
+         {
+             Slot &slot = slots[i];
+             if (slot.key == key)
+             {
+                 slot.value = value;
+                 return;
+             }
+             if (slot.key == EmptyKey)
+             {
+                 slot.key = key;
+                 slot.value = value;
+                 ++count;
+                 return;
+             }
+         }
+     }
+ 
+     /**
+      * @brief Remove @p key, shifting later members of its probe run back into the hole.
+      * @return true if the key was present.
+      */
+     bool erase(int key)
+     {
+         if (key == EmptyKey)
+         {
+             bool had = hasEmptyKey;
+             hasEmptyKey = false;
+             return had;
+         }
+         if (slots.empty())
+             return false;
+ 
+         std::size_t hole = home(key);
+         for (;; hole = (hole + 1) & mask)
+         {
+             if (slots[hole].key == key)
+                 break;
+             if (slots[hole].key == EmptyKey)
+                 return false;
+         }
+ 
+         // Backward-shift: pull forward any entry whose home is not in (hole, j]
+         for (std::size_t j = (hole + 1) & mask; slots[j].key != EmptyKey; j = (j + 1) & mask)
+         {
+             std::size_t k = home(slots[j].key);
+             bool stays = hole <= j ? (hole < k && k <= j) : (hole < k || k <= j);
+             if (!stays)
+             {
+                 slots[hole] = slots[j];
+                 hole = j;
+             }
+         }
+         slots[hole].key = EmptyKey;
+         --count;
+         return true;
+     }
+ 
+ private:
+     static constexpr int EmptyKey = std::numeric_limits<int>::min(); ///< Marks an unused slot
+     static constexpr std::size_t MinSlots = 16;                     ///< Smallest table allocated
+ 
+     struct Slot
+     {
+         int key = EmptyKey;  ///< Order ID, or EmptyKey
+         Value value{};       ///< Mapped value
+     };
+ 
+     static std::size_t tableSizeFor(std::size_t entries)
+     {
+         std::size_t n = MinSlots;
+         while (n < entries * 2)
+             n *= 2;
+         return n;
+     }
+ 
+     /// @brief Home slot of @p key (Fibonacci hashing spreads sequential IDs).
+     std::size_t home(int key) const
+     {
+         std::uint64_t h = static_cast<std::uint32_t>(key) * 0x9E3779B97F4A7C15ull;
+         return static_cast<std::size_t>(h >> shift);
+     }
+ 
+     void rehash(std::size_t newSize)
+     {
+         std::vector<Slot> old(newSize);
+         old.swap(slots);
+         mask = newSize - 1;
+         shift = 64;
+         for (std::size_t n = newSize; n > 1; n >>= 1)
+             --shift;
+         count = 0;
+         for (const Slot &slot : old)
+             if (slot.key != EmptyKey)
+                 insert(slot.key, slot.value);
+     }
+ 
+     std::vector<Slot> slots;     ///< Power-of-two probe table
+     std::size_t mask = 0;        ///< slots.size() - 1
+     unsigned shift = 64;         ///< 64 - log2(slots.size())
+     std::size_t count = 0;       ///< Entries stored in slots
+     bool hasEmptyKey = false;    ///< True if key EmptyKey is present
+     Value emptyKeyValue{};       ///< Value for key EmptyKey
+ };
+ 
+ #endif // ORDER_ID_MAP_H
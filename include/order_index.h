@@ -0,0 +1,139 @@
+/**
+ * @file order_index.h
+ * @brief Order ID -> pool handle index with an optional direct-indexed window.
+ *
+ * When the engine assigns IDs from an increasing counter, live IDs occupy a
+ * narrow, dense range. In direct mode the index keeps that range in a
+ * power-of-two ring of handles addressed by ID, so cancel/modify lookups are a
+ * single indexed load. The window's base advances as the oldest IDs retire,
+ * keeping memory proportional to the live ID span (capped at MaxWindow).
+ * IDs that fall outside the window (stale, or sparse client IDs) go to an
+ * OrderIdMap fallback.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef ORDER_INDEX_H
+ #define ORDER_INDEX_H
+ 
+ #include "order_id_map.h"
+ #include "order_pool.h"
+ #include <cstddef>
+ #include <cstdint>
+ #include <vector>
+ 
+ /**
+  * @class OrderIndex
+  * @brief Hash-only or direct-window + hash index from order ID to OrderHandle.
+  */
+ class OrderIndex
+ {
+ public:
+     /**
+      * @brief Construct an index.
+      * @param directIds Enable the direct-indexed window for dense, engine-assigned IDs.
+      */
+     explicit OrderIndex(bool directIds = false) : directMode(directIds) {}
+ 
+     /// @brief True if the direct-indexed window is enabled.
+     bool direct() const { return directMode; }
+ 
+     /// @brief Number of indexed orders.
+     std::size_t size() const { return directCount + sparse.size(); }
+ 
+     /**
+      * @brief Pre-size storage for @p orders live entries.
+      * @param orders Expected number of live orders.
+      */
+     void reserve(std::size_t orders);
+ 
+     /**
+      * @brief Look up the handle for @p id.
+      * @return The handle, or NullHandle if the ID is not indexed.
+      */
+     OrderHandle find(int id) const
+     {
+         if (id >= base && id < top)
+         {
+             OrderHandle h = ring[slot(id)];
+             if (h != NullHandle)
+                 return h;
+         }
+         if (sparse.empty())
+             return NullHandle;
+         const OrderHandle *h = sparse.find(id);
+         return h ? *h : NullHandle;
+     }
+ 
+     /// @brief Hint that @p id will be looked up soon.
+     void prefetch(int id) const
+     {
+         if (id >= base && id < base + static_cast<long long>(ring.size()))
+             prefetchRead(&ring[slot(id)]);
+         else
+             sparse.prefetch(id);
+     }
+ 
+     /// @brief Index @p id -> @p h (overwrites an existing entry for the same ID).
+     void insert(int id, OrderHandle h)
+     {
+         if (directMode && id >= base && id < base + static_cast<long long>(ring.size()))
+         {
+             OrderHandle &cell = ring[slot(id)];
+             if (cell == NullHandle)
+                 ++directCount;
+             cell = h;
+             if (id >= top)
+                 top = static_cast<long long>(id) + 1;
+             return;
+         }
+         insertSlow(id, h);
+     }
+ 
+     /**
+      * @brief Remove @p id from the index.
+      * @return true if it was present.
+      */
+     bool erase(int id)
+     {
+         if (id >= base && id < top)
+         {
+             OrderHandle &cell = ring[slot(id)];
+             if (cell != NullHandle)
+             {
+                 cell = NullHandle;
+                 --directCount;
+                 // Retire the oldest IDs so the window slides forward
+                 while (base < top && ring[slot(base)] == NullHandle)
+                     ++base;
+                 return true;
+             }
+         }
+         return sparse.erase(id);
+     }
+ 
+ private:
+     static constexpr std::size_t InitialWindow = std::size_t{1} << 10; ///< First ring allocation (IDs)
+     static constexpr std::size_t MaxWindow = std::size_t{1} << 22;     ///< Largest ring (16 MiB of handles)
+ 
+     std::size_t slot(long long id) const
+     {
+         return static_cast<std::size_t>(static_cast<unsigned long long>(id)) & (ring.size() - 1);
+     }
+ 
+     /// @brief Start, grow or slide the window for @p id, or fall back to the hash index.
+     void insertSlow(int id, OrderHandle h);
+ 
+     /// @brief Reallocate the ring to @p newSize slots, keeping [base, top).
+     void resize(std::size_t newSize);
+ 
+     bool directMode;                     ///< Direct window enabled
+     std::vector<OrderHandle> ring;       ///< Handles for IDs [base, base + ring.size()), by id & mask
+     long long base = 0;                  ///< Oldest ID still covered by the window
+     long long top = 0;                   ///< One past the highest ID placed in the window
+     std::size_t directCount = 0;         ///< Live entries in the ring
+     OrderIdMap<OrderHandle> sparse;      ///< Fallback for IDs outside the window
+ };
+ 
+ #endif // ORDER_INDEX_H
@@ -0,0 +1,185 @@
+/**
+ * @file order_pool.h
+ * @brief Slab pool of order nodes with intrusive FIFO queues per price level.
+ *
+ * Resting orders live in fixed-size chunks owned by the OrderPool and are
+ * addressed by a 32-bit OrderHandle. Each node carries prev/next handles so a
+ * price level's queue is just a head/tail pair, and released nodes are
+ * recycled through a free list threaded through the same next link. Once the
+ * pool has grown to the book's working depth, adding, filling and canceling
+ * orders performs no heap allocation.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef ORDER_POOL_H
+ #define ORDER_POOL_H
+ 
+ #include "order.h"
+ #include "prefetch.h"
+ #include <cstddef>
+ #include <cstdint>
+ #include <memory>
+ #include <vector>
+ 
+ struct PriceLevel;
+ 
+ /// Index of a node inside an OrderPool.
+ using OrderHandle = std::uint32_t;
+ 
+ /// Sentinel handle meaning "no node".
+ constexpr OrderHandle NullHandle = static_cast<OrderHandle>(-1);
+ 
+ /// Timer slot of a node that is not scheduled for expiry.
+ constexpr std::uint32_t NoTimerSlot = static_cast<std::uint32_t>(-1);
+ 
+ /**
+  * @struct OrderNode
+  * @brief Pool slot holding one resting order and its intrusive queue links.
+  */
+ struct OrderNode
+ {
+     Order order{0, OrderType::BUY, 0, 0, 0}; ///< The resting order
+     OrderHandle prev = NullHandle;           ///< Older order in the same level
+     OrderHandle next = NullHandle;           ///< Newer order in the same level (free-list link when released)
+     PriceLevel *level = nullptr;             ///< Level the order rests in
+     OrderHandle timerPrev = NullHandle;      ///< Previous node in the same expiry slot
+     OrderHandle timerNext = NullHandle;      ///< Next node in the same expiry slot
+     std::uint32_t timerSlot = NoTimerSlot;   ///< TimerWheel slot holding the node, if scheduled
+     OrderHandle ownerPrev = NullHandle;      ///< Previous node of the same owner
+     OrderHandle ownerNext = NullHandle;      ///< Next node of the same owner
+ };
+ 
+ /**
+  * @struct OrderQueue
+  * @brief Head/tail of an intrusive FIFO of pool nodes (front = oldest).
+  */
+ struct OrderQueue
+ {
+     OrderHandle head = NullHandle;  ///< Oldest order
+     OrderHandle tail = NullHandle;  ///< Newest order
+ 
+     bool empty() const { return head == NullHandle; }
+ };
+ 
+ /**
+  * @class OrderPool
+  * @brief Chunked slab of OrderNodes with stable addresses and O(1) acquire/release.
+  */
+ class OrderPool
+ {
+ public:
+     /**
+      * @brief Pre-allocate room for at least @p nodes orders.
+      * @param nodes Number of nodes to make available without further allocation.
+      */
+     void reserve(std::size_t nodes);
+ 
+     /// @brief Number of nodes the pool can hand out without allocating.
+     std::size_t capacity() const { return chunks.size() * ChunkSize; }
+ 
+     /// @brief Number of nodes currently in use.
+     std::size_t size() const { return live; }
+ 
+     /**
+      * @brief Take a node from the free list (or a fresh chunk) and store @p order in it.
+      * @return Handle of the node; its links are reset.
+      */
+     OrderHandle acquire(const Order &order)
+     {
+         OrderHandle h;
+         if (freeHead != NullHandle)
+         {
+             h = freeHead;
+             freeHead = (*this)[h].next;
+         }
+         else
+         {
+             if (nextUnused == capacity())
+                 grow();
+             h = static_cast<OrderHandle>(nextUnused++);
+         }
+ 
+         OrderNode &node = (*this)[h];
+         node.order = order;
+         node.prev = NullHandle;
+         node.next = NullHandle;
+         node.level = nullptr;
+         node.timerSlot = NoTimerSlot;
+         ++live;
+         return h;
+     }
+ 
+     /// @brief Return a node (already unlinked from any queue) to the free list.
+     void release(OrderHandle h)
+     {
+         (*this)[h].next = freeHead;
+         freeHead = h;
+         --live;
+     }
+ 
+     /**
+      * @brief Return a whole queue of @p count nodes to the free list in O(1).
+      *
+      * The queue's next links already chain its nodes, so it is spliced onto
+      * the front of the free list as is. @p queue is left empty.
+      */
+     void releaseAll(OrderQueue &queue, std::size_t count)
+     {
+         if (queue.empty())
+             return;
+         (*this)[queue.tail].next = freeHead;
+         freeHead = queue.head;
+         live -= count;
+         queue = OrderQueue{};
+     }
+ 
+     OrderNode &operator[](OrderHandle h) { return chunks[h >> ChunkBits][h & ChunkMask]; }
+     const OrderNode &operator[](OrderHandle h) const { return chunks[h >> ChunkBits][h & ChunkMask]; }
+ 
+     /// @brief Hint that node @p h will be touched soon.
+     void prefetch(OrderHandle h) const { prefetchRead(&(*this)[h]); }
+ 
+     /// @brief Append node @p h to the back of @p queue.
+     void pushBack(OrderQueue &queue, OrderHandle h)
+     {
+         OrderNode &node = (*this)[h];
+         node.prev = queue.tail;
+         node.next = NullHandle;
+         if (queue.tail != NullHandle)
+             (*this)[queue.tail].next = h;
+         else
+             queue.head = h;
+         queue.tail = h;
+     }
+ 
+     /// @brief Remove node @p h from @p queue in O(1).
+     void unlink(OrderQueue &queue, OrderHandle h)
+     {
+         OrderNode &node = (*this)[h];
+         if (node.prev != NullHandle)
+             (*this)[node.prev].next = node.next;
+         else
+             queue.head = node.next;
+         if (node.next != NullHandle)
+             (*this)[node.next].prev = node.prev;
+         else
+             queue.tail = node.prev;
+     }
+ 
+ private:
+     static constexpr unsigned ChunkBits = 8;                        ///< 256 nodes per chunk (keeps quiet books small)
+     static constexpr std::size_t ChunkSize = std::size_t{1} << ChunkBits;
+     static constexpr std::size_t ChunkMask = ChunkSize - 1;
+ 
+     /// @brief Allocate one more chunk.
+     void grow();
+ 
+     std::vector<std::unique_ptr<OrderNode[]>> chunks; ///< Fixed-size node slabs (never moved)
+     OrderHandle freeHead = NullHandle;                ///< Most recently released node
+     std::size_t nextUnused = 0;                       ///< First never-used slot
+     std::size_t live = 0;                             ///< Nodes currently handed out
+ };
+ 
+ #endif // ORDER_POOL_H
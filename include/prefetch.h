@@ -0,0 +1,31 @@
+/**
+ * @file prefetch.h
+ * @brief Portable software-prefetch hint used by the batch submission paths.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef PREFETCH_H
+ #define PREFETCH_H
+ 
+ #ifdef _MSC_VER
+ #include <xmmintrin.h>
+ #endif
+ 
+ /**
+  * @brief Hint that @p addr will be read soon. Never faults; a no-op where unsupported.
+  * @param addr Address whose cache line should be brought in.
+  */
+ inline void prefetchRead(const void *addr)
+ {
+ #if defined(__GNUC__) || defined(__clang__)
+     __builtin_prefetch(addr, 0, 3);
+ #elif defined(_MSC_VER)
+     _mm_prefetch(static_cast<const char *>(addr), _MM_HINT_T0);
+ #else
+     (void)addr;
+ #endif
+ }
+ 
+ #endif // PREFETCH_H
@@ -0,0 +1,56 @@
+/**
+ * @file price.h
+ * @brief Fixed-point price representation used throughout the order book.
+ *
+ * Prices are stored as a signed 64-bit count of ticks so that level identity,
+ * comparisons and hashing are exact. Conversion to and from decimal prices
+ * happens only at the edges (parsing, printing, CSV export) through a
+ * PriceScale built from the book's tick size.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef PRICE_H
+ #define PRICE_H
+ 
+ #include <cmath>
+ #include <cstdint>
+ #include <stdexcept>
+ 
+ /// Price expressed as an integer number of ticks.
+ using Price = std::int64_t;
+ 
+ /**
+  * @class PriceScale
+  * @brief Converts between decimal prices and integer ticks for a given tick size.
+  */
+ class PriceScale
+ {
+ public:
+     /**
+      * @brief Construct a scale for @p tickSize.
+      * @throws std::invalid_argument if tickSize is not positive.
+      */
+     explicit PriceScale(double tickSize)
+         : tick(tickSize), ticksPerUnit(1.0 / tickSize)
+     {
+         if (!(tickSize > 0.0))
+             throw std::invalid_argument("PriceScale requires tickSize > 0");
+     }
+ 
+     /// @brief Round a decimal price to the nearest tick.
+     Price toTicks(double price) const { return std::llround(price * ticksPerUnit); }
+ 
+     /// @brief Decimal value of @p ticks (division keeps decimal tick sizes exact when printed).
+     double toDouble(Price ticks) const { return static_cast<double>(ticks) / ticksPerUnit; }
+ 
+     /// @brief Tick size the scale was built from.
+     double tickSize() const { return tick; }
+ 
+ private:
+     double tick;          ///< Minimum price increment
+     double ticksPerUnit;  ///< Ticks per 1.0 of price
+ };
+ 
+ #endif // PRICE_H
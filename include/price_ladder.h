@@ -0,0 +1,289 @@
+/**
+ * @file price_ladder.h
+ * @brief Price-level containers ("ladders") backing one side of the OrderBook.
+ *
+ * Two interchangeable ladders are provided:
+ *  - MapLadder: a std::map of levels; accepts any price, O(log levels) insert.
+ *  - DenseLadder: a pre-sized array of levels indexed by tick within a fixed
+ *    price band, with a TickBitmap of occupied ticks for O(1) best-price access.
+ *
+ * Both expose the same interface (best, find, seek, insert, erase, forEach,
+ * forEachWhile, prefetch) so the OrderBook can be instantiated over either.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef PRICE_LADDER_H
+ #define PRICE_LADDER_H
+ 
+ #include "book_config.h"
+ #include "order.h"
+ #include "order_pool.h"
+ #include "prefetch.h"
+ #include "price.h"
+ #include "tick_bitmap.h"
+ #include <cstdint>
+ #include <functional>
+ #include <limits>
+ #include <map>
+ #include <stdexcept>
+ #include <type_traits>
+ #include <vector>
+ 
+ /**
+  * @struct PriceLevel
+  * @brief FIFO queue of resting orders sharing a single price.
+  *
+  * The level also caches its aggregate displayed and hidden quantity and its
+  * order count, maintained on every add, fill, refill and cancel, so depth
+  * queries never walk the queue.
+  */
+ struct PriceLevel
+ {
+     Price price;                    ///< Price (ticks) shared by every order in the level
+     OrderQueue orders{};            ///< Intrusive queue of pooled orders (head = oldest)
+     std::int64_t totalQty = 0;      ///< Sum of displayed quantity of resting orders
+     std::int64_t hiddenQty = 0;     ///< Sum of iceberg reserves behind the displayed quantity
+     std::uint32_t orderCount = 0;   ///< Number of resting orders
+     OrderHandle topOrder = NullHandle; ///< Order that opened the level, while it still rests there unrequeued
+ };
+ 
+ /**
+  * @class MapLadder
+  * @brief Sorted map of price levels for one side of the book.
+  * @tparam Side BUY ladders iterate highest price first, SELL ladders lowest first.
+  */
+ template <OrderType Side>
+ class MapLadder
+ {
+ public:
+     explicit MapLadder(const BookConfig &) {}
+ 
+     /// @brief Any price can be represented by a map ladder.
+     bool accepts(Price) const { return true; }
+ 
+     bool empty() const { return levels.empty(); }
+ 
+     /// @brief Best level (highest bid / lowest ask), or nullptr if the side is empty.
+     PriceLevel *best() { return levels.empty() ? nullptr : &levels.begin()->second; }
+     const PriceLevel *best() const { return levels.empty() ? nullptr : &levels.begin()->second; }
+ 
+     /// @brief Level at @p price, or nullptr if none rests there.
+     PriceLevel *find(Price price)
+     {
+         auto pos = levels.find(price);
+         return pos == levels.end() ? nullptr : &pos->second;
+     }
+     const PriceLevel *find(Price price) const
+     {
+         auto pos = levels.find(price);
+         return pos == levels.end() ? nullptr : &pos->second;
+     }
+ 
+     /// @brief First level at @p price or worse (best-to-worst order), or nullptr.
+     PriceLevel *seek(Price price)
+     {
+         auto pos = levels.lower_bound(price);
+         return pos == levels.end() ? nullptr : &pos->second;
+     }
+ 
+     /// @brief No-op: a tree node cannot be located without walking the tree.
+     void prefetch(Price) const {}
+ 
+     /// @brief Level at @p price, created empty if missing.
+     PriceLevel &insert(Price price)
+     {
+         auto pos = levels.lower_bound(price);
+         if (pos == levels.end() || pos->first != price)
+             pos = levels.emplace_hint(pos, price, PriceLevel{price});
+         return pos->second;
+     }
+ 
+     /// @brief Remove an (empty) level from the ladder.
+     void erase(PriceLevel &level)
+     {
+         Price price = level.price;
+         levels.erase(price);
+     }
+ 
+     /// @brief Visit up to @p maxLevels levels from best to worst.
+     template <typename Fn>
+     void forEach(Fn &&fn, std::size_t maxLevels = std::numeric_limits<std::size_t>::max()) const
+     {
+         for (auto pos = levels.begin(); pos != levels.end() && maxLevels > 0; ++pos, --maxLevels)
+             fn(pos->second);
+     }
+ 
+     /// @brief Visit levels from best to worst until @p fn returns false.
+     template <typename Fn>
+     void forEachWhile(Fn &&fn) const
+     {
+         for (const auto &entry : levels)
+             if (!fn(entry.second))
+                 return;
+     }
+ 
+ private:
+     using Compare = std::conditional_t<Side == OrderType::BUY, std::greater<Price>, std::less<Price>>;
+ 
+     std::map<Price, PriceLevel, Compare> levels; ///< Levels keyed by price, best first
+ };
+ 
+ /**
+  * @class DenseLadder
+  * @brief Array of price levels indexed by tick inside a bounded price band.
+  *
+  * Level storage is allocated once at construction, so inserting or removing a
+  * level never allocates. The best level is cached; when it empties, the next
+  * best is found through the occupancy bitmap rather than by walking levels.
+  *
+  * @tparam Side BUY ladders treat the highest occupied tick as best, SELL the lowest.
+  */
+ template <OrderType Side>
+ class DenseLadder
+ {
+ public:
+     /**
+      * @brief Allocate one level per tick in [minPrice, maxPrice].
+      * @throws std::invalid_argument if the band or tick size is not usable.
+      */
+     explicit DenseLadder(const BookConfig &config)
+         : minTick(PriceScale(config.tickSize).toTicks(config.minPrice)),
+           occupied(validTicks(config))
+     {
+         levels.resize(occupied.size());
+         for (std::size_t i = 0; i < levels.size(); ++i)
+             levels[i].price = minTick + static_cast<Price>(i);
+     }
+ 
+     /// @brief True if @p price falls inside the configured band.
+     bool accepts(Price price) const
+     {
+         return price >= minTick && static_cast<std::size_t>(price - minTick) < levels.size();
+     }
+ 
+     bool empty() const { return bestIdx == TickBitmap::npos; }
+ 
+     /// @brief Best level (highest bid / lowest ask), or nullptr if the side is empty.
+     PriceLevel *best() { return empty() ? nullptr : &levels[bestIdx]; }
+     const PriceLevel *best() const { return empty() ? nullptr : &levels[bestIdx]; }
+ 
+     /// @brief Level at @p price, or nullptr if none rests there.
+     PriceLevel *find(Price price)
+     {
+         if (!accepts(price))
+             return nullptr;
+         std::size_t i = index(price);
+         return occupied.test(i) ? &levels[i] : nullptr;
+     }
+     const PriceLevel *find(Price price) const
+     {
+         return const_cast<DenseLadder *>(this)->find(price);
+     }
+ 
+     /// @brief First occupied level at @p price or worse (best-to-worst order), or nullptr.
+     PriceLevel *seek(Price price)
+     {
+         // The bitmap searches clamp positions past the band themselves
+         std::size_t i;
+         if (Side == OrderType::BUY)
+             i = price < minTick ? TickBitmap::npos : occupied.findPrev(index(price));
+         else
+             i = occupied.findNext(price < minTick ? 0 : index(price));
+         return i == TickBitmap::npos ? nullptr : &levels[i];
+     }
+ 
+     /// @brief Hint that the level at @p price will be touched soon (ignored outside the band).
+     void prefetch(Price price) const
+     {
+         if (accepts(price))
+             prefetchRead(&levels[index(price)]);
+     }
+ 
+     /**
+      * @brief Level at @p price, marked occupied if it was empty. Price must be accepted.
+      *
+      * A freed slot is reused for the next level at its tick, so its cached
+      * aggregates are reset here: erase() may be handed a level whose totals
+      * were never settled (e.g. by uncross()).
+      */
+     PriceLevel &insert(Price price)
+     {
+         std::size_t i = index(price);
+         if (!occupied.test(i))
+         {
+             PriceLevel &level = levels[i];
+             level.totalQty = 0;
+             level.hiddenQty = 0;
+             level.orderCount = 0;
+             level.topOrder = NullHandle;
+             occupied.set(i);
+             if (empty() || better(i, bestIdx))
+                 bestIdx = i;
+         }
+         return levels[i];
+     }
+ 
+     /// @brief Mark an (empty) level free, moving the cached best if needed.
+     void erase(PriceLevel &level)
+     {
+         std::size_t i = static_cast<std::size_t>(&level - levels.data());
+         occupied.clear(i);
+         if (i == bestIdx)
+             bestIdx = next(i);
+     }
+ 
+     /// @brief Visit up to @p maxLevels occupied levels from best to worst.
+     template <typename Fn>
+     void forEach(Fn &&fn, std::size_t maxLevels = std::numeric_limits<std::size_t>::max()) const
+     {
+         for (std::size_t i = bestIdx; i != TickBitmap::npos && maxLevels > 0; i = next(i), --maxLevels)
+             fn(levels[i]);
+     }
+ 
+     /// @brief Visit occupied levels from best to worst until @p fn returns false.
+     template <typename Fn>
+     void forEachWhile(Fn &&fn) const
+     {
+         for (std::size_t i = bestIdx; i != TickBitmap::npos; i = next(i))
+             if (!fn(levels[i]))
+                 return;
+     }
+ 
+ private:
+     static std::size_t validTicks(const BookConfig &config)
+     {
+         PriceScale scale(config.tickSize);
+         Price lo = scale.toTicks(config.minPrice);
+         Price hi = scale.toTicks(config.maxPrice);
+         if (hi < lo)
+             throw std::invalid_argument("DenseLadder requires maxPrice >= minPrice");
+         return static_cast<std::size_t>(hi - lo) + 1;
+     }
+ 
+     std::size_t index(Price price) const
+     {
+         return static_cast<std::size_t>(price - minTick);
+     }
+ 
+     static bool better(std::size_t a, std::size_t b)
+     {
+         return Side == OrderType::BUY ? a > b : a < b;
+     }
+ 
+     /// @brief Next occupied tick strictly worse than @p i.
+     std::size_t next(std::size_t i) const
+     {
+         if (Side == OrderType::BUY)
+             return i == 0 ? TickBitmap::npos : occupied.findPrev(i - 1);
+         return occupied.findNext(i + 1);
+     }
+ 
+     Price minTick;                     ///< Price (ticks) of array slot 0
+     TickBitmap occupied;               ///< Ticks holding at least one order
+     std::vector<PriceLevel> levels;    ///< One level per tick
+     std::size_t bestIdx = TickBitmap::npos; ///< Cached best occupied tick
+ };
+ 
+ #endif // PRICE_LADDER_H
@@ -0,0 +1,131 @@
+/**
+ * @file sequenced_engine.h
+ * @brief Multi-gateway front end: an MPSC sequencer feeding one matching thread.
+ *
+ * Any number of gateway threads submit through the engine without taking a
+ * lock. Each request gets the next global sequence number and is queued in a
+ * padded slot; the matching thread applies requests strictly in that order to
+ * the BookManager it alone owns. The sequence number takes the role of the
+ * CLI's timestamp counter: an order's priority timestamp is its sequence
+ * number plus one, whatever the gateway put in Order::timestamp, so
+ * Order::expireAt and advanceTime() are in sequence units too.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef SEQUENCED_ENGINE_H
+ #define SEQUENCED_ENGINE_H
+ 
+ #include "book_config.h"
+ #include "book_manager.h"
+ #include "engine_command.h"
+ #include "mpsc_sequencer.h"
+ #include "order.h"
+ #include "price.h"
+ #include <atomic>
+ #include <cstddef>
+ #include <cstdint>
+ #include <optional>
+ #include <string>
+ #include <thread>
+ 
+ /**
+  * @struct SequencerConfig
+  * @brief Queue and thread settings for a SequencedEngine.
+  */
+ struct SequencerConfig
+ {
+     std::size_t capacity = 1 << 16;       ///< Sequencer slots (rounded up to a power of two)
+     bool pinThread = true;                ///< Pin the matching thread to @ref core (Linux only)
+     unsigned core = 0;                    ///< Core for the matching thread
+     bool autoExport = false;              ///< Auto-export setting of every book
+     std::string exportDir = "exports";    ///< Export root (one subdirectory per symbol)
+ };
+ 
+ /**
+  * @class SequencedEngine
+  * @brief Lock-free multi-producer entry to a single-threaded BookManager.
+  *
+  * addOrder, cancelOrder, modifyOrder and advanceTime may be called from any
+  * number of threads at once and return the request's sequence number.
+  * intern() is not thread-safe: register symbols before gateways use them (or
+  * from one thread that also serializes with them). drain() and stop() must
+  * not race with submissions, and books may only be inspected after drain().
+  */
+ class SequencedEngine
+ {
+ public:
+     /**
+      * @brief Start the matching thread.
+      * @param queue Sequencer size, pinning and export settings.
+      * @param config Config of every book.
+      */
+     explicit SequencedEngine(const SequencerConfig &queue = SequencerConfig{}, const BookConfig &config = BookConfig{});
+ 
+     /// @brief Drain outstanding requests and join the matching thread.
+     ~SequencedEngine();
+ 
+     SequencedEngine(const SequencedEngine &) = delete;
+     SequencedEngine &operator=(const SequencedEngine &) = delete;
+ 
+     /// @brief Intern @p symbol, returning its routing id (see class notes on threading).
+     SymbolId intern(const std::string &symbol);
+ 
+     /// @brief Id of @p symbol if it has been interned.
+     std::optional<SymbolId> findSymbol(const std::string &symbol) const { return symbols.find(symbol); }
+ 
+     /// @brief Symbol string of @p id.
+     const std::string &symbolName(SymbolId id) const { return symbols.name(id); }
+ 
+     /// @brief Price scale shared by every book (decimal price to ticks).
+     const PriceScale &priceScale() const { return scale; }
+ 
+     /// @brief True if the matching thread was pinned to its core.
+     bool isPinned() const { return pinned; }
+ 
+     /// @brief Sequence an order for symbol @p id; its timestamp becomes the sequence number + 1.
+     std::uint64_t addOrder(SymbolId id, const Order &order);
+ 
+     /// @brief Sequence a cancel for symbol @p id.
+     std::uint64_t cancelOrder(SymbolId id, int orderId);
+ 
+     /// @brief Sequence a modify for symbol @p id; a re-queued order is stamped like an add.
+     std::uint64_t modifyOrder(SymbolId id, int orderId, int newQty, Price newPrice);
+ 
+     /// @brief Sequence a clock advance of every book (see BookManager::advanceTime).
+     std::uint64_t advanceTime(long now);
+ 
+     /// @brief Wait until every request sequenced so far has been applied.
+     void drain();
+ 
+     /// @brief Drain, then stop and join the matching thread. Further submissions are not allowed.
+     void stop();
+ 
+     /// @brief Requests rejected so far (adds to an un-interned symbol, cancels and modifies of an unknown order or symbol); call after drain().
+     std::uint64_t rejectedCount() const { return rejected; }
+ 
+     /// @brief Visit every created book as fn(SymbolId, OrderBook&); call after drain().
+     template <typename Fn>
+     void forEachBook(Fn &&fn) { books.forEachBook(std::forward<Fn>(fn)); }
+ 
+     /// @brief Book of symbol @p id, or nullptr if it has not been created; call after drain().
+     OrderBook *findBook(SymbolId id) { return books.findBook(id); }
+ 
+ private:
+     /// @brief Matching thread body: apply requests in sequence order until stopped and empty.
+     void run();
+ 
+     SymbolTable symbols;                      ///< Symbol ids handed to gateways
+     PriceScale scale;                         ///< Tick conversion of the book config
+     MpscSequencer<EngineCommand> sequencer;   ///< Gateways -> matching thread
+     BookManager books;                        ///< Owned by the matching thread
+     std::uint64_t rejected = 0;               ///< Rejected requests (matching thread only)
+     alignas(CacheLine) std::atomic<std::uint64_t> applied{0};  ///< Requests applied
+     std::atomic<bool> stopping{false};        ///< Set once by stop()
+     std::thread matcher;                      ///< Matching thread
+     bool pinned = false;                      ///< Matching thread pinned
+     bool stopped = false;                     ///< Matching thread joined
+ };
+ 
+ #endif // SEQUENCED_ENGINE_H
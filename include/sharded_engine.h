@@ -0,0 +1,160 @@
+/**
+ * @file sharded_engine.h
+ * @brief Threaded engine mode: symbols sharded across pinned workers, each fed by its own SPSC ring.
+ *
+ * Every worker thread owns a BookManager holding a disjoint set of books
+ * (symbol id modulo the worker count) and is the only thread that touches
+ * them, so the books stay single-writer and lock-free. The submitting thread
+ * turns each request into an EngineCommand and pushes it onto the owning
+ * worker's ring; a symbol's commands therefore reach its book in submission
+ * order, and its matching is identical to running that book on one thread.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef SHARDED_ENGINE_H
+ #define SHARDED_ENGINE_H
+ 
+ #include "book_config.h"
+ #include "book_manager.h"
+ #include "engine_command.h"
+ #include "order.h"
+ #include "price.h"
+ #include "spsc_ring.h"
+ #include <atomic>
+ #include <cstddef>
+ #include <cstdint>
+ #include <memory>
+ #include <optional>
+ #include <string>
+ #include <thread>
+ #include <vector>
+ 
+ /**
+  * @struct ShardConfig
+  * @brief Threading settings for a ShardedEngine.
+  */
+ struct ShardConfig
+ {
+     std::size_t workers = 1;               ///< Worker threads (shards)
+     std::size_t queueCapacity = 1 << 16;   ///< Commands per worker ring (rounded up to a power of two)
+     bool pinThreads = true;                ///< Pin worker i to core firstCore + i (Linux only)
+     unsigned firstCore = 0;                ///< First core used for pinning
+     bool autoExport = false;               ///< Auto-export setting of every book
+     std::string exportDir = "exports";     ///< Export root (one subdirectory per symbol)
+ };
+ 
+ /**
+  * @class ShardedEngine
+  * @brief Multi-threaded front end over per-worker BookManagers.
+  *
+  * All submitting calls (intern, addOrder, cancelOrder, modifyOrder,
+  * advanceTime, drain, stop) must come from one thread. Submission never
+  * blocks on matching: it only waits when the target ring is full. Cancel and
+  * modify results are not returned; rejections are counted per worker.
+  * Books may only be inspected (forEachBook) after drain(), and until the
+  * next submission.
+  */
+ class ShardedEngine
+ {
+ public:
+     /**
+      * @brief Start the worker threads.
+      * @param shards Worker count, ring size, pinning and export settings.
+      * @param books Config of every book.
+      */
+     explicit ShardedEngine(const ShardConfig &shards = ShardConfig{}, const BookConfig &books = BookConfig{});
+ 
+     /// @brief Drain outstanding commands and join the workers.
+     ~ShardedEngine();
+ 
+     ShardedEngine(const ShardedEngine &) = delete;
+     ShardedEngine &operator=(const ShardedEngine &) = delete;
+ 
+     /// @brief Intern @p symbol, returning its routing id (its book is created on first order).
+     SymbolId intern(const std::string &symbol);
+ 
+     /// @brief Id of @p symbol if it has been interned.
+     std::optional<SymbolId> findSymbol(const std::string &symbol) const { return symbols.find(symbol); }
+ 
+     /// @brief Symbol string of @p id.
+     const std::string &symbolName(SymbolId id) const { return symbols.name(id); }
+ 
+     /// @brief Price scale shared by every book (decimal price to ticks).
+     const PriceScale &priceScale() const { return scale; }
+ 
+     /// @brief Number of worker threads.
+     std::size_t workerCount() const { return workers.size(); }
+ 
+     /// @brief Worker owning symbol @p id.
+     std::size_t shardOf(SymbolId id) const { return id % workers.size(); }
+ 
+     /// @brief True if worker @p w was pinned to its core.
+     bool isPinned(std::size_t w) const { return workers[w]->pinned; }
+ 
+     /// @brief Queue an order for symbol @p id's book (see OrderBook::addOrder).
+     void addOrder(SymbolId id, const Order &order);
+ 
+     /// @brief Queue a cancel for symbol @p id's book.
+     void cancelOrder(SymbolId id, int orderId);
+ 
+     /// @brief Queue a modify for symbol @p id's book.
+     void modifyOrder(SymbolId id, int orderId, int newQty, Price newPrice, long newTimestamp);
+ 
+     /// @brief Queue a clock advance to every book (see BookManager::advanceTime).
+     void advanceTime(long now);
+ 
+     /// @brief Wait until every worker has processed everything submitted so far.
+     void drain();
+ 
+     /// @brief Drain, then stop and join the workers. Further submissions are not allowed.
+     void stop();
+ 
+     /// @brief Requests rejected so far (adds to an un-interned symbol, cancels and modifies of an unknown order or symbol); call after drain().
+     std::uint64_t rejectedCount() const;
+ 
+     /// @brief Visit every created book as fn(SymbolId, OrderBook&), grouped by worker; call after drain().
+     template <typename Fn>
+     void forEachBook(Fn &&fn)
+     {
+         const SymbolId n = static_cast<SymbolId>(workers.size());
+         for (SymbolId w = 0; w < n; ++w)
+             workers[w]->books.forEachBook([&](SymbolId local, OrderBook &book) { fn(local * n + w, book); });
+     }
+ 
+ private:
+     /**
+      * @struct Worker
+      * @brief One shard: its inbound ring, its books and the thread that drains them.
+      */
+     struct Worker
+     {
+         Worker(std::size_t capacity, const BookConfig &config) : inbox(capacity), books(config) {}
+ 
+         SpscRing<EngineCommand> inbox;   ///< Commands from the submitting thread
+         BookManager books;               ///< Books of this shard, by shard-local id
+         std::thread thread;              ///< Worker thread
+         bool pinned = false;             ///< Pinned to its core
+         std::uint64_t submitted = 0;     ///< Commands pushed (submitting thread only)
+         std::uint64_t rejected = 0;      ///< Rejected requests (worker thread only)
+         alignas(CacheLine) std::atomic<std::uint64_t> processed{0};  ///< Commands applied
+     };
+ 
+     /// @brief Push @p cmd onto worker @p w's ring, waiting while it is full.
+     void push(std::size_t w, EngineCommand &&cmd);
+ 
+     /// @brief Queue @p cmd on symbol @p id's worker, with the id made shard-local.
+     void route(SymbolId id, EngineCommand &&cmd);
+ 
+     /// @brief Worker thread body: apply commands until stopped and empty.
+     void run(Worker &worker);
+ 
+     SymbolTable symbols;                            ///< Global symbol ids
+     PriceScale scale;                               ///< Tick conversion of the book config
+     std::vector<std::unique_ptr<Worker>> workers;   ///< Shards, by worker index
+     std::atomic<bool> stopping{false};              ///< Set once by stop()
+     bool stopped = false;                           ///< Workers joined
+ };
+ 
+ #endif // SHARDED_ENGINE_H
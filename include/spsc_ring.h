@@ -0,0 +1,111 @@
+/**
+ * @file spsc_ring.h
+ * @brief Bounded lock-free single-producer/single-consumer ring used to feed engine workers.
+ *
+ * One thread calls tryPush(), one other thread calls tryPop(); no other
+ * synchronization is needed. The producer and consumer indices live on
+ * separate cache lines, and each side keeps a private copy of the other's
+ * index so it only touches the shared line when the ring looks full (or
+ * empty). Slots are published with release/acquire, so everything the
+ * producer wrote before a push is visible to the consumer after the pop.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef SPSC_RING_H
+ #define SPSC_RING_H
+ 
+ #include "cache_line.h"
+ #include <atomic>
+ #include <cstddef>
+ #include <utility>
+ #include <vector>
+ 
+ /**
+  * @class SpscRing
+  * @brief Fixed-capacity FIFO of @p T between exactly one producer and one consumer thread.
+  * @tparam T Default-constructible, move-assignable element type.
+  */
+ template <typename T>
+ class SpscRing
+ {
+ public:
+     /**
+      * @brief Construct an empty ring.
+      * @param capacity Minimum number of elements; rounded up to a power of two.
+      */
+     explicit SpscRing(std::size_t capacity)
+     {
+         std::size_t size = 2;
+         while (size < capacity)
+             size <<= 1;
+         slots.resize(size);
+         mask = size - 1;
+     }
+ 
+     SpscRing(const SpscRing &) = delete;
+     SpscRing &operator=(const SpscRing &) = delete;
+ 
+     /// @brief Number of slots.
+     std::size_t capacity() const { return slots.size(); }
+ 
+     /**
+      * @brief Append @p value (producer thread only).
+      * @return false if the ring is full; @p value is left untouched.
+      */
+     bool tryPush(T &&value)
+     {
+         std::size_t t = tail.value.load(std::memory_order_relaxed);
+         if (t - headCache == slots.size())
+         {
+             headCache = head.value.load(std::memory_order_acquire);
+             if (t - headCache == slots.size())
+                 return false;
+         }
+         slots[t & mask] = std::move(value);
+         tail.value.store(t + 1, std::memory_order_release);
+         return true;
+     }
+ 
+     /**
+      * @brief Remove the oldest element into @p out (consumer thread only).
+      * @return false if the ring is empty.
+      */
+     bool tryPop(T &out)
+     {
+         std::size_t h = head.value.load(std::memory_order_relaxed);
+         if (h == tailCache)
+         {
+             tailCache = tail.value.load(std::memory_order_acquire);
+             if (h == tailCache)
+                 return false;
+         }
+         out = std::move(slots[h & mask]);
+         head.value.store(h + 1, std::memory_order_release);
+         return true;
+     }
+ 
+     /// @brief True if nothing is queued (exact only when both sides are idle).
+     bool empty() const
+     {
+         return head.value.load(std::memory_order_acquire) == tail.value.load(std::memory_order_acquire);
+     }
+ 
+ private:
+     /// @brief Index padded to its own cache line so producer and consumer never false-share.
+     struct alignas(CacheLine) PaddedIndex
+     {
+         std::atomic<std::size_t> value{0};
+     };
+ 
+     std::vector<T> slots;  ///< Element storage (power-of-two size)
+     std::size_t mask = 0;  ///< slots.size() - 1
+ 
+     PaddedIndex head;                              ///< Next slot to pop (written by the consumer)
+     alignas(CacheLine) std::size_t tailCache = 0;  ///< Consumer's last view of tail
+     PaddedIndex tail;                              ///< Next slot to push (written by the producer)
+     alignas(CacheLine) std::size_t headCache = 0;  ///< Producer's last view of head
+ };
+ 
+ #endif // SPSC_RING_H
@@ -0,0 +1,38 @@
+/**
+ * @file thread_affinity.h
+ * @brief Portable helper pinning an engine thread to one CPU core.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef THREAD_AFFINITY_H
+ #define THREAD_AFFINITY_H
+ 
+ #include <thread>
+ 
+ #ifdef __linux__
+ #include <pthread.h>
+ #include <sched.h>
+ #endif
+ 
+ /**
+  * @brief Restrict @p thread to core @p core (taken modulo the core count).
+  * @return true if the affinity was applied; always false where unsupported.
+  */
+ inline bool pinToCore(std::thread &thread, unsigned core)
+ {
+ #ifdef __linux__
+     const unsigned cores = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+     cpu_set_t set;
+     CPU_ZERO(&set);
+     CPU_SET(core % cores, &set);
+     return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+ #else
+     (void)thread;
+     (void)core;
+     return false;
+ #endif
+ }
+ 
+ #endif // THREAD_AFFINITY_H
@@ -0,0 +1,189 @@
+/**
+ * @file tick_bitmap.h
+ * @brief Hierarchical occupancy bitmap used to locate the next occupied price tick.
+ *
+ * Each layer summarizes the one below it: bit j of layer k+1 is set when word j
+ * of layer k is non-zero. Finding the next or previous occupied tick therefore
+ * takes one count-trailing/leading-zeros per layer (three layers cover 262,144
+ * ticks) instead of a linear scan.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef TICK_BITMAP_H
+ #define TICK_BITMAP_H
+ 
+ #include <cstddef>
+ #include <cstdint>
+ #include <vector>
+ 
+ #ifdef _MSC_VER
+ #include <intrin.h>
+ #endif
+ 
+ /**
+  * @class TickBitmap
+  * @brief Fixed-size set of tick indices with O(layers) next/previous lookups.
+  */
+ class TickBitmap
+ {
+ public:
+     static constexpr std::size_t npos = static_cast<std::size_t>(-1); ///< Returned when no bit is found
+ 
+     /**
+      * @brief Construct an empty bitmap.
+      * @param size Number of addressable ticks.
+      */
+     explicit TickBitmap(std::size_t size) : numTicks(size)
+     {
+         std::size_t bits = size == 0 ? 1 : size;
+         do
+         {
+             std::size_t words = (bits + 63) / 64;
+             layers.emplace_back(words, 0);
+             bits = words;
+         } while (bits > 1);
+     }
+ 
+     /// @brief Number of addressable ticks.
+     std::size_t size() const { return numTicks; }
+ 
+     /// @brief True if tick @p i is occupied.
+     bool test(std::size_t i) const
+     {
+         return (layers[0][i >> 6] >> (i & 63)) & 1u;
+     }
+ 
+     /// @brief Mark tick @p i occupied, propagating to parent layers only on a 0 -> non-zero word.
+     void set(std::size_t i)
+     {
+         for (auto &words : layers)
+         {
+             std::uint64_t &word = words[i >> 6];
+             bool wasEmpty = word == 0;
+             word |= std::uint64_t{1} << (i & 63);
+             if (!wasEmpty)
+                 return;
+             i >>= 6;
+         }
+     }
+ 
+     /// @brief Mark tick @p i free, propagating to parent layers only when a word empties.
+     void clear(std::size_t i)
+     {
+         for (auto &words : layers)
+         {
+             std::uint64_t &word = words[i >> 6];
+             word &= ~(std::uint64_t{1} << (i & 63));
+             if (word != 0)
+                 return;
+             i >>= 6;
+         }
+     }
+ 
+     /**
+      * @brief Find the lowest occupied tick >= @p i.
+      * @return Tick index, or npos if none.
+      */
+     std::size_t findNext(std::size_t i) const
+     {
+         if (i >= numTicks)
+             return npos;
+ 
+         // Ascend until some word has a set bit at or after the position
+         std::size_t layer = 0;
+         for (;;)
+         {
+             if (layer == layers.size())
+                 return npos;
+             const auto &words = layers[layer];
+             std::size_t w = i >> 6;
+             if (w >= words.size())
+                 return npos;
+             std::uint64_t bits = words[w] & (~std::uint64_t{0} << (i & 63));
+             if (bits)
+             {
+                 i = (w << 6) | ctz(bits);
+                 break;
+             }
+             i = w + 1;
+             ++layer;
+         }
+ 
+         // Descend taking the lowest set bit of each summarized word
+         while (layer > 0)
+         {
+             --layer;
+             i = (i << 6) | ctz(layers[layer][i]);
+         }
+         return i;
+     }
+ 
+     /**
+      * @brief Find the highest occupied tick <= @p i.
+      * @return Tick index, or npos if none.
+      */
+     std::size_t findPrev(std::size_t i) const
+     {
+         if (numTicks == 0)
+             return npos;
+         if (i >= numTicks)
+             i = numTicks - 1;
+ 
+         // Ascend until some word has a set bit at or before the position
+         std::size_t layer = 0;
+         for (;;)
+         {
+             if (layer == layers.size())
+                 return npos;
+             std::size_t w = i >> 6;
+             std::uint64_t bits = layers[layer][w] & (~std::uint64_t{0} >> (63 - (i & 63)));
+             if (bits)
+             {
+                 i = (w << 6) | (63 - clz(bits));
+                 break;
+             }
+             if (w == 0)
+                 return npos;
+             i = w - 1;
+             ++layer;
+         }
+ 
+         // Descend taking the highest set bit of each summarized word
+         while (layer > 0)
+         {
+             --layer;
+             i = (i << 6) | (63 - clz(layers[layer][i]));
+         }
+         return i;
+     }
+ 
+ private:
+     static std::size_t ctz(std::uint64_t x)
+     {
+ #ifdef _MSC_VER
+         unsigned long idx;
+         _BitScanForward64(&idx, x);
+         return idx;
+ #else
+         return static_cast<std::size_t>(__builtin_ctzll(x));
+ #endif
+     }
+ 
+     static std::size_t clz(std::uint64_t x)
+     {
+ #ifdef _MSC_VER
+         unsigned long idx;
+         _BitScanReverse64(&idx, x);
+         return 63 - idx;
+ #else
+         return static_cast<std::size_t>(__builtin_clzll(x));
+ #endif
+     }
+ 
+     std::size_t numTicks;                           ///< Number of addressable ticks
+     std::vector<std::vector<std::uint64_t>> layers; ///< layers[0] = leaf words, back() = single root word
+ };
+ 
+ #endif // TICK_BITMAP_H
@@ -0,0 +1,145 @@
+/**
+ * @file timer_wheel.h
+ * @brief Hierarchical timer wheel scheduling pooled orders for good-till-time expiry.
+ *
+ * Four levels of 64 slots cover 2^24 clock units ahead of the wheel's current
+ * time; an entry sits at the level of the highest 6-bit group in which its
+ * expiry differs from the current time and cascades one level down when the
+ * clock enters its slot. Expiries further out wait in an overflow list that is
+ * re-examined each time the clock crosses a 2^24 boundary. Each level keeps a
+ * 64-bit occupancy mask, so advancing jumps straight to the next non-empty
+ * slot instead of ticking through idle time.
+ *
+ * Entries are pool nodes linked through OrderNode::timerPrev/timerNext, so
+ * scheduling and canceling are O(1) and allocate nothing.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef TIMER_WHEEL_H
+ #define TIMER_WHEEL_H
+ 
+ #include "order_pool.h"
+ #include <array>
+ #include <cstddef>
+ #include <cstdint>
+ 
+ /**
+  * @class TimerWheel
+  * @brief Expiry schedule for OrderPool nodes keyed by Order::expireAt.
+  *
+  * Times are the caller's clock units (the book's timestamps) and must be
+  * non-negative.
+  */
+ class TimerWheel
+ {
+ public:
+     /**
+      * @brief Construct an empty wheel.
+      * @param start Initial current time.
+      */
+     explicit TimerWheel(long start = 0) : current(static_cast<std::uint64_t>(start)) { heads.fill(NullHandle); }
+ 
+     /// @brief Current time of the wheel (the last time passed to advance).
+     long now() const { return static_cast<long>(current); }
+ 
+     /// @brief Number of scheduled nodes.
+     std::size_t size() const { return count; }
+ 
+     /**
+      * @brief Schedule node @p h to expire at its order's expireAt.
+      *
+      * An expiry at or before now() fires on the next advance.
+      *
+      * @param pool Pool owning the node.
+      * @param h Node to schedule (not currently scheduled).
+      */
+     void schedule(OrderPool &pool, OrderHandle h)
+     {
+         place(pool, h);
+         ++count;
+     }
+ 
+     /**
+      * @brief Unschedule node @p h in O(1). No-op if it is not scheduled.
+      * @param pool Pool owning the node.
+      * @param h Node to unschedule.
+      */
+     void cancel(OrderPool &pool, OrderHandle h)
+     {
+         if (pool[h].timerSlot == NoTimerSlot)
+             return;
+         unlink(pool, h);
+         --count;
+     }
+ 
+     /**
+      * @brief Move the clock to @p now, expiring every node whose time has come.
+      *
+      * Nodes are handed to @p onExpire in expiry-time order, already
+      * unscheduled; the callback may release them.
+      *
+      * @param pool Pool owning the nodes.
+      * @param now New current time (ignored if not ahead of now()).
+      * @param onExpire Callable invoked as onExpire(OrderHandle).
+      * @return Number of nodes expired.
+      */
+     template <typename Fn>
+     std::size_t advance(OrderPool &pool, long now, Fn &&onExpire)
+     {
+         if (now < static_cast<long>(current))
+             return 0;
+         std::uint64_t target = static_cast<std::uint64_t>(now);
+         std::size_t expired = 0;
+         std::uint64_t t;
+         while (nextEvent(t) && t <= target)
+         {
+             current = t;
+             cascadeAt(pool, t);
+ 
+             std::uint32_t slot = static_cast<std::uint32_t>(t & SlotMask);
+             while (heads[slot] != NullHandle)
+             {
+                 OrderHandle h = heads[slot];
+                 unlink(pool, h);
+                 --count;
+                 ++expired;
+                 onExpire(h);
+             }
+         }
+         if (target > current)
+             current = target;
+         return expired;
+     }
+ 
+ private:
+     static constexpr unsigned SlotBits = 6;                                  ///< log2(slots per level)
+     static constexpr std::uint32_t Slots = 1u << SlotBits;                   ///< Slots per level
+     static constexpr std::uint64_t SlotMask = Slots - 1;
+     static constexpr unsigned Levels = 4;                                    ///< Wheel levels
+     static constexpr unsigned SpanBits = SlotBits * Levels;                  ///< log2 of the covered horizon
+     static constexpr std::uint32_t OverflowSlot = Levels * Slots;            ///< List for expiries beyond the horizon
+ 
+     /// @brief Link @p h into the slot matching its expiry relative to the current time.
+     void place(OrderPool &pool, OrderHandle h);
+ 
+     /// @brief Push @p h onto the front of @p slot.
+     void link(OrderPool &pool, OrderHandle h, std::uint32_t slot);
+ 
+     /// @brief Remove @p h from its slot.
+     void unlink(OrderPool &pool, OrderHandle h);
+ 
+     /// @brief Re-place entries of every slot (and the overflow list) whose range starts at @p t.
+     void cascadeAt(OrderPool &pool, std::uint64_t t);
+ 
+     /// @brief Earliest time at which a slot expires or cascades; false if the wheel is empty.
+     bool nextEvent(std::uint64_t &t) const;
+ 
+     std::array<OrderHandle, Levels * Slots + 1> heads;  ///< Slot list heads (last = overflow)
+     std::array<std::uint64_t, Levels> occupied{};       ///< Per-level mask of non-empty slots
+     std::uint64_t current;                              ///< Current time
+     std::size_t count = 0;                              ///< Scheduled nodes
+ };
+ 
+ #endif // TIMER_WHEEL_H
@@ -0,0 +1,160 @@
+/**
+ * @file top_of_book.h
+ * @brief Seqlock-published best bid/offer and last trade, for readers on other threads.
+ *
+ * The matching thread owns the book; strategy, risk and UI threads only need
+ * the top of it. A book with a SeqlockTopOfBook attached writes its BBO, last
+ * trade and event sequence there after every public mutation, and any number
+ * of readers copy it out without locks and without writing to shared memory,
+ * so they never slow the matcher down by bouncing its cache lines.
+ *
+ * Protocol: the writer makes the version odd, stores the fields and makes the
+ * version even again. A reader loads the version, copies the fields and loads
+ * the version again; the copy is consistent if both loads saw the same even
+ * value. Fields are relaxed atomics so a read that overlaps a write is a
+ * detected retry rather than a data race.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #ifndef TOP_OF_BOOK_H
+ #define TOP_OF_BOOK_H
+ 
+ #include "cache_line.h"
+ #include "price.h"
+ #include <atomic>
+ #include <cstdint>
+ 
+ /**
+  * @struct TopOfBook
+  * @brief Plain snapshot of a book's best levels and last trade.
+  *
+  * A side with no orders has quantity 0 (its price is then meaningless);
+  * lastQty is 0 until the first trade.
+  */
+ struct TopOfBook
+ {
+     Price bidPrice = 0;              ///< Best bid in ticks
+     std::int64_t bidQty = 0;         ///< Displayed quantity at the best bid (0 if no bids)
+     Price askPrice = 0;              ///< Best ask in ticks
+     std::int64_t askQty = 0;         ///< Displayed quantity at the best ask (0 if no asks)
+     Price lastPrice = 0;             ///< Price of the most recent trade
+     int lastQty = 0;                 ///< Quantity of the most recent trade (0 before the first)
+     long lastTime = 0;               ///< Timestamp of the most recent trade
+     std::uint64_t sequence = 0;      ///< Book events applied when the snapshot was taken (see BasicOrderBook::sequence)
+ 
+     /// @brief Same book state (sequence is ignored).
+     bool sameState(const TopOfBook &other) const
+     {
+         return bidPrice == other.bidPrice && bidQty == other.bidQty && askPrice == other.askPrice &&
+                askQty == other.askQty && lastPrice == other.lastPrice && lastQty == other.lastQty &&
+                lastTime == other.lastTime;
+     }
+ };
+ 
+ /**
+  * @class SeqlockTopOfBook
+  * @brief Single-writer, multi-reader TopOfBook behind a sequence lock.
+  *
+  * The version and every published field share one cache line, so a reader
+  * misses at most one line per snapshot. The version is 32 bits (as in the
+  * Linux kernel's seqcount) to make room for the event sequence: a reader
+  * would have to stall across 2^31 publishes to be fooled by wraparound.
+  *
+  * Every event advances the sequence, so every event publishes. The writer
+  * keeps a private copy of the last published state on a separate line, and
+  * when the top is unchanged it stores only the sequence between the two
+  * version stores.
+  *
+  * publish() must only be called from one thread at a time (the book's
+  * owner); tryRead(), read() and sequence() may be called from any thread.
+  */
+ class alignas(CacheLine) SeqlockTopOfBook
+ {
+ public:
+     /**
+      * @brief Publish @p top (writer only).
+      * @param top New state, stamped with the book's event sequence.
+      */
+     void publish(const TopOfBook &top)
+     {
+         bool changed = !written || !top.sameState(shadow);
+ 
+         std::uint32_t v = line.version.load(std::memory_order_relaxed);
+         line.version.store(v + 1, std::memory_order_relaxed);
+         // Orders the odd version before the field stores
+         std::atomic_thread_fence(std::memory_order_release);
+         if (changed)
+         {
+             shadow = top;
+             written = true;
+             line.bidPrice.store(top.bidPrice, std::memory_order_relaxed);
+             line.bidQty.store(top.bidQty, std::memory_order_relaxed);
+             line.askPrice.store(top.askPrice, std::memory_order_relaxed);
+             line.askQty.store(top.askQty, std::memory_order_relaxed);
+             line.lastPrice.store(top.lastPrice, std::memory_order_relaxed);
+             line.lastQty.store(top.lastQty, std::memory_order_relaxed);
+             line.lastTime.store(top.lastTime, std::memory_order_relaxed);
+         }
+         line.sequence.store(top.sequence, std::memory_order_relaxed);
+         line.version.store(v + 2, std::memory_order_release);
+     }
+ 
+     /**
+      * @brief Copy the current snapshot in one attempt (wait-free).
+      * @param out Receives the snapshot; only meaningful when true is returned.
+      * @return false if a publish overlapped the copy.
+      */
+     bool tryRead(TopOfBook &out) const
+     {
+         std::uint32_t before = line.version.load(std::memory_order_acquire);
+         if (before & 1)
+             return false;
+         out.bidPrice = line.bidPrice.load(std::memory_order_relaxed);
+         out.bidQty = line.bidQty.load(std::memory_order_relaxed);
+         out.askPrice = line.askPrice.load(std::memory_order_relaxed);
+         out.askQty = line.askQty.load(std::memory_order_relaxed);
+         out.lastPrice = line.lastPrice.load(std::memory_order_relaxed);
+         out.lastQty = line.lastQty.load(std::memory_order_relaxed);
+         out.lastTime = line.lastTime.load(std::memory_order_relaxed);
+         out.sequence = line.sequence.load(std::memory_order_relaxed);
+         // Orders the field loads before the version re-check
+         std::atomic_thread_fence(std::memory_order_acquire);
+         return line.version.load(std::memory_order_relaxed) == before;
+     }
+ 
+     /// @brief Copy the current snapshot, retrying while a publish overlaps.
+     TopOfBook read() const
+     {
+         TopOfBook top;
+         while (!tryRead(top))
+             ;
+         return top;
+     }
+ 
+     /// @brief Event sequence of the latest publish.
+     std::uint64_t sequence() const { return line.sequence.load(std::memory_order_acquire); }
+ 
+ private:
+     /// @brief Reader-visible state: version and fields on one cache line.
+     struct alignas(CacheLine) Line
+     {
+         std::atomic<std::uint32_t> version{0};   ///< Odd while a publish is in progress
+         std::atomic<std::int32_t> lastQty{0};    ///< See TopOfBook
+         std::atomic<std::uint64_t> sequence{0};  ///< See TopOfBook
+         std::atomic<Price> bidPrice{0};          ///< See TopOfBook
+         std::atomic<std::int64_t> bidQty{0};     ///< See TopOfBook
+         std::atomic<Price> askPrice{0};          ///< See TopOfBook
+         std::atomic<std::int64_t> askQty{0};     ///< See TopOfBook
+         std::atomic<Price> lastPrice{0};         ///< See TopOfBook
+         std::atomic<long> lastTime{0};           ///< See TopOfBook
+     };
+     static_assert(sizeof(Line) == CacheLine, "published fields must fit one cache line");
+ 
+     Line line;                               ///< Shared with readers
+     alignas(CacheLine) TopOfBook shadow;     ///< Last published state (writer only)
+     bool written = false;                    ///< Anything published yet
+ };
+ 
+ #endif // TOP_OF_BOOK_H
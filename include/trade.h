@@ -9,6 +9,7 @@
  #ifndef TRADE_H
  #define TRADE_H
  
+ #include "price.h"
  #include <cstdint>
  
  /**
@@ -23,7 +24,7 @@
  {
      int buyId;       ///< The ID of the buy order.
      int sellId;      ///< The ID of the sell order.
-     double price;    ///< The execution price of the trade.
+     Price price;     ///< The execution price of the trade, in ticks.
      int quantity;    ///< The quantity of units traded.
      long timestamp;  ///< Logical or real timestamp of when the trade occurred.
  
@@ -31,11 +32,11 @@
       * @brief Constructs a Trade instance.
       * @param buyId The ID of the buy order.
       * @param sellId The ID of the sell order.
-      * @param price The execution price.
+      * @param price The execution price in ticks.
       * @param quantity The quantity traded.
       * @param timestamp The time the trade occurred.
       */
-     Trade(int buyId, int sellId, double price, int quantity, long timestamp)
+     Trade(int buyId, int sellId, Price price, int quantity, long timestamp)
          : buyId(buyId), sellId(sellId), price(price), quantity(quantity), timestamp(timestamp) {}
  };
  
@@ -0,0 +1,78 @@
+/**
+ * @file book_manager.cpp
+ * @brief Symbol interning and lazy per-symbol book construction for the BookManager.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "book_manager.h"
+ 
+ SymbolId SymbolTable::intern(const std::string &symbol)
+ {
+     auto [pos, inserted] = ids.emplace(symbol, static_cast<SymbolId>(names.size()));
+     if (inserted)
+         names.push_back(&pos->first);
+     return pos->second;
+ }
+ 
+ std::optional<SymbolId> SymbolTable::find(const std::string &symbol) const
+ {
+     auto pos = ids.find(symbol);
+     if (pos == ids.end())
+         return std::nullopt;
+     return pos->second;
+ }
+ 
+ SymbolId BookManager::intern(const std::string &symbol)
+ {
+     SymbolId id = symbols.intern(symbol);
+     if (id == books.size())
+     {
+         books.emplace_back();
+         overrides.emplace_back();
+     }
+     return id;
+ }
+ 
+ bool BookManager::configure(SymbolId id, const BookConfig &config)
+ {
+     if (books.at(id))
+         return false;
+     overrides[id] = config;
+     return true;
+ }
+ 
+ OrderBook &BookManager::create(SymbolId id)
+ {
+     books[id] = std::make_unique<OrderBook>(overrides[id] ? *overrides[id] : defaults);
+     ++liveBooks;
+ 
+     OrderBook &created = *books[id];
+     created.setAutoExport(autoExport);
+     created.setExportDir(exportDir + "/" + symbols.name(id));
+     if (clock > 0)
+         created.startClockAt(clock);  // Join the shared clock so GTT checks agree across books
+     return created;
+ }
+ 
+ std::size_t BookManager::advanceTime(long now)
+ {
+     if (now > clock)
+         clock = now;
+     std::size_t expired = 0;
+     forEachBook([&](SymbolId, OrderBook &book) { expired += book.advanceTime(now); });
+     return expired;
+ }
+ 
+ void BookManager::setAutoExport(bool on)
+ {
+     autoExport = on;
+     forEachBook([on](SymbolId, OrderBook &book) { book.setAutoExport(on); });
+ }
+ 
+ void BookManager::setExportDir(const std::string &dir)
+ {
+     exportDir = dir.empty() ? "." : dir;
+     forEachBook([this](SymbolId id, OrderBook &book) { book.setExportDir(exportDir + "/" + symbols.name(id)); });
+ }
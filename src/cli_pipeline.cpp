@@ -0,0 +1,457 @@
+/**
+ * @file cli_pipeline.cpp
+ * @brief Stage bodies of the CLI pipeline: command parsing, sequencing, matching and output.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "cli_pipeline.h"
+ #include "order_book.h"
+ #include "thread_affinity.h"
+ #include <chrono>
+ #include <istream>
+ #include <optional>
+ #include <ostream>
+ #include <random>
+ #include <sstream>
+ #include <thread>
+ 
+ CliPipeline::CliPipeline(const PipelineConfig &config)
+     : config(config), scale(config.book.tickSize), ring(config.capacity, StageCount), engine(config.book)
+ {
+     // Directory for CSV exports (one subdirectory per symbol)
+     engine.setExportDir(config.exportDir);
+     engine.setAutoExport(config.autoExport);
+ 
+     // Unprefixed commands always have a book; other symbols get one with their first order
+     defaultSymbol = symbols.intern("DEFAULT");
+     engine.book(engine.intern("DEFAULT"));
+ 
+     if (!config.journalPath.empty())
+         journal.open(config.journalPath, std::ios::app);
+ }
+ 
+ void CliPipeline::run(std::istream &in, std::ostream &out, std::ostream &err)
+ {
+     std::thread sequencer([this] {
+         runStage(Sequence, [this](CliRequest &req) { sequence(req); }, [this] {
+             if (journal.is_open())
+                 journal.flush();
+         });
+     });
+     std::thread matcher([this] {
+         runStage(Match, [this](CliRequest &req) { match(req); }, [] {});
+     });
+     std::thread encoder([this, &out, &err] {
+         runStage(Encode, [&](CliRequest &req) { encode(req, out, err); }, [&] { out.flush(); });
+     });
+     if (config.pinThreads)
+     {
+         pinToCore(sequencer, config.firstCore);
+         pinToCore(matcher, config.firstCore + 1);
+         pinToCore(encoder, config.firstCore + 2);
+     }
+ 
+     // Decode on this thread: fill free slots with parsed lines until EXIT or end of input
+     IdleBackoff backoff;
+     std::string line;
+     bool done = false;
+     while (!done)
+     {
+         std::size_t free = ring.available(Decode);
+         if (free == 0)
+         {
+             backoff.pause();
+             continue;
+         }
+         backoff.reset();
+ 
+         std::size_t filled = 0;
+         while (filled < free && !done)
+         {
+             CliRequest &req = ring.at(Decode, filled);
+             if (!std::getline(in, line))
+             {
+                 req.kind = CliRequest::Kind::Exit;
+                 req.echo = false;
+                 done = true;
+                 ++filled;
+                 break;
+             }
+             if (line.empty())
+                 continue; // Ignore blank lines
+             decode(line, req);
+             done = req.kind == CliRequest::Kind::Exit;
+             ++filled;
+ 
+             // Hand over what is parsed rather than wait on input for a full batch
+             if (in.rdbuf()->in_avail() <= 0)
+                 break;
+         }
+         ring.commit(Decode, filled);
+     }
+ 
+     sequencer.join();
+     matcher.join();
+     encoder.join();
+ }
+ 
+ template <typename Handle, typename AfterBatch>
+ void CliPipeline::runStage(Stage s, Handle &&handle, AfterBatch &&afterBatch)
+ {
+     IdleBackoff backoff;
+     bool done = false;
+     while (!done)
+     {
+         std::size_t n = ring.available(s);
+         if (n == 0)
+         {
+             backoff.pause();
+             continue;
+         }
+         backoff.reset();
+ 
+         for (std::size_t i = 0; i < n && !done; ++i)
+         {
+             CliRequest &req = ring.at(s, i);
+             handle(req);
+             done = req.kind == CliRequest::Kind::Exit;
+         }
+         afterBatch();
+         ring.commit(s, n);
+     }
+ }
+ 
+ void CliPipeline::decode(const std::string &line, CliRequest &req)
+ {
+     req.text.assign(line);
+     req.echo = true;
+     req.valid = false;
+     req.newSymbol = nullptr;
+     req.order = Order(0, OrderType::BUY, 0, 0, 0);
+     req.argument = 0;
+ 
+     std::istringstream iss(line);
+     std::string &command = req.command;
+     command.clear();
+     iss >> command;
+ 
+     // Optional @SYMBOL prefix: intern once, then route by dense id
+     req.symbol = defaultSymbol;
+     if (command.size() > 1 && command[0] == '@') {
+         std::size_t known = symbols.size();
+         req.symbol = symbols.intern(command.substr(1));
+         if (symbols.size() != known)
+             req.newSymbol = &symbols.name(req.symbol);
+         iss >> command;
+     }
+ 
+     using Kind = CliRequest::Kind;
+     Order &order = req.order;
+ 
+     // ------------------------------------------------
+     // BUY / SELL: Create a new order
+     // BUY <price> <qty> [LIMIT|MARKET|IOC|FOK|STOP <stopPrice>|STOP_LIMIT <stopPrice>]
+     //                   [displayQty] [GTT <expireAt>] [OWNER <ownerId>]
+     // ------------------------------------------------
+     if (command == "BUY" || command == "SELL") {
+         req.kind = Kind::Order;
+         double price;
+         if (iss >> price >> order.quantity) {
+             req.valid = true;
+             order.type = (command == "BUY") ? OrderType::BUY : OrderType::SELL;
+             order.price = scale.toTicks(price);
+ 
+             // Optional order kind, stop trigger, iceberg slice size and expiry
+             std::string option;
+             while (iss >> option) {
+                 if (option == "LIMIT")
+                     order.kind = OrderKind::LIMIT;
+                 else if (option == "MARKET")
+                     order.kind = OrderKind::MARKET;
+                 else if (option == "IOC")
+                     order.kind = OrderKind::IOC;
+                 else if (option == "FOK")
+                     order.kind = OrderKind::FOK;
+                 else if (option == "STOP" || option == "STOP_LIMIT") {
+                     double stopPrice = 0.0;
+                     iss >> stopPrice;
+                     order.kind = option == "STOP" ? OrderKind::STOP : OrderKind::STOP_LIMIT;
+                     order.stopPrice = scale.toTicks(stopPrice);
+                 }
+                 else if (option == "GTT")
+                     iss >> order.expireAt;
+                 else if (option == "OWNER")
+                     iss >> order.owner;
+                 else
+                     std::istringstream(option) >> order.displayQty;
+             }
+         }
+     }
+     // ------------------------------------------------
+     // CANCEL <id>
+     // ------------------------------------------------
+     else if (command == "CANCEL") {
+         req.kind = Kind::Cancel;
+         req.valid = static_cast<bool>(iss >> order.id);
+     }
+     // ------------------------------------------------
+     // CANCEL_ALL <BUY|SELL>
+     // CANCEL_RANGE <BUY|SELL> <lo> <hi>
+     // CANCEL_OWNER <ownerId>
+     // ------------------------------------------------
+     else if (command == "CANCEL_ALL" || command == "CANCEL_RANGE") {
+         req.kind = command == "CANCEL_ALL" ? Kind::CancelAll : Kind::CancelRange;
+         std::string side;
+         double lo = 0.0, hi = 0.0;
+         iss >> side;
+         order.type = side == "BUY" ? OrderType::BUY : OrderType::SELL;
+         req.valid = req.kind == Kind::CancelAll || static_cast<bool>(iss >> lo >> hi);
+         order.price = scale.toTicks(lo);
+         order.stopPrice = scale.toTicks(hi);
+     }
+     else if (command == "CANCEL_OWNER") {
+         req.kind = Kind::CancelOwner;
+         req.valid = static_cast<bool>(iss >> req.argument);
+     }
+     // ------------------------------------------------
+     // MODIFY <id> <qty> <price>
+     // ------------------------------------------------
+     else if (command == "MODIFY") {
+         req.kind = Kind::Modify;
+         double price;
+         if (iss >> order.id >> order.quantity >> price) {
+             req.valid = true;
+             order.price = scale.toTicks(price);
+         }
+     }
+     // ------------------------------------------------
+     // TIME <now>
+     // ------------------------------------------------
+     else if (command == "TIME") {
+         req.kind = Kind::Time;
+         req.valid = static_cast<bool>(iss >> req.argument);
+     }
+     // ------------------------------------------------
+     // AUCTION <ON|OFF>
+     // ------------------------------------------------
+     else if (command == "AUCTION") {
+         req.kind = Kind::Auction;
+         std::string mode;
+         iss >> mode;
+         req.on = mode == "ON";
+     }
+     else if (command == "UNCROSS")
+         req.kind = Kind::Uncross;
+     else if (command == "PRINT")
+         req.kind = Kind::Print;
+     else if (command == "TRADES")
+         req.kind = Kind::Trades;
+     else if (command == "EXPORT_BOOK")
+         req.kind = Kind::ExportBook;
+     else if (command == "EXPORT_TRADES")
+         req.kind = Kind::ExportTrades;
+     // ------------------------------------------------
+     // BENCH <numOrders>
+     // ------------------------------------------------
+     else if (command == "BENCH") {
+         req.kind = Kind::Bench;
+         iss >> req.argument;
+         if (req.argument <= 0) req.argument = 100000;
+     }
+     else if (command == "EXIT")
+         req.kind = Kind::Exit;
+     else
+         req.kind = Kind::Unknown;
+ }
+ 
+ void CliPipeline::sequence(CliRequest &req)
+ {
+     if (req.echo && journal.is_open())
+         journal << req.text << "\n";
+ 
+     // IDs and timestamps are handed out in line order, exactly as a single loop would
+     if (req.symbol >= nextIds.size())
+         nextIds.resize(req.symbol + 1, 1);
+     int &nextId = nextIds[req.symbol];
+ 
+     if (req.kind == CliRequest::Kind::Order && req.valid) {
+         req.order.id = nextId++;
+         req.order.timestamp = timestamp++;
+     }
+     else if (req.kind == CliRequest::Kind::Modify && req.valid) {
+         req.order.timestamp = timestamp++;
+     }
+     else if (req.kind == CliRequest::Kind::Bench) {
+         // Reserve the benchmark's ID and timestamp ranges up front
+         req.order.id = nextId;
+         req.order.timestamp = timestamp;
+         nextId += static_cast<int>(req.argument);
+         timestamp += req.argument;
+     }
+ }
+ 
+ void CliPipeline::match(CliRequest &req)
+ {
+     using Kind = CliRequest::Kind;
+     req.ok = false;
+     req.unknownSymbol = false;
+     req.affected = 0;
+     req.output.clear();
+     if (!req.echo)
+         return; // End of input
+ 
+     // Only commands that bring orders create a book; the rest need an existing one
+     if (req.newSymbol)
+         engine.intern(*req.newSymbol);
+     OrderBook *target = engine.findBook(req.symbol);
+     bool creates = (req.kind == Kind::Order && req.valid) || req.kind == Kind::Auction || req.kind == Kind::Bench;
+     if (!target && creates)
+         target = &engine.book(req.symbol);
+     if (!target && req.kind != Kind::Time && req.kind != Kind::Unknown && req.kind != Kind::Exit)
+     {
+         req.unknownSymbol = true;
+         req.output = engine.symbolName(req.symbol);
+         return;
+     }
+     const Order &order = req.order;
+ 
+     switch (req.kind)
+     {
+     case Kind::Order:
+         if (req.valid)
+             target->addOrder(order);
+         break;
+     case Kind::Cancel:
+         req.ok = req.valid && target->cancelOrder(order.id);
+         break;
+     case Kind::CancelAll:
+         req.affected = target->cancelAll(order.type);
+         break;
+     case Kind::CancelRange:
+         if (req.valid)
+             req.affected = target->cancelRange(order.type, order.price, order.stopPrice);
+         break;
+     case Kind::CancelOwner:
+         if (req.valid)
+             req.affected = target->cancelByOwner(static_cast<int>(req.argument));
+         break;
+     case Kind::Modify:
+         req.ok = req.valid && target->modifyOrder(order.id, order.quantity, order.price, order.timestamp);
+         break;
+     case Kind::Time:
+         if (req.valid)
+             req.affected = engine.advanceTime(req.argument);
+         break;
+     case Kind::Auction:
+         target->setAuctionMode(req.on);
+         break;
+     case Kind::Uncross:
+     {
+         std::optional<Price> px = target->uncross();
+         req.ok = px.has_value();
+         if (px)
+             req.clearing = target->toPrice(*px);
+         break;
+     }
+     case Kind::Print:
+     case Kind::Trades:
+     case Kind::ExportBook:
+     case Kind::ExportTrades:
+     case Kind::Bench:
+     {
+         std::ostringstream text;
+         if (req.kind == Kind::Print)
+             target->printBook(text);
+         else if (req.kind == Kind::Trades)
+             target->printTrades(text);
+         else if (req.kind == Kind::ExportBook)
+             target->exportBookCSV("book", text);
+         else if (req.kind == Kind::ExportTrades)
+             target->exportTradesCSV("trades", text);
+         else
+         {
+             // Fixed RNG seed for repeatability
+             std::mt19937 rng(42);
+             std::uniform_real_distribution<double> priceDist(90.0, 110.0);
+             std::uniform_int_distribution<int> qtyDist(1, 5);
+             std::uniform_int_distribution<int> sideDist(0, 1);
+             const int numOrders = static_cast<int>(req.argument);
+ 
+             auto start = std::chrono::high_resolution_clock::now();
+ 
+             for (int i = 0; i < numOrders; i++) {
+                 OrderType type = sideDist(rng) ? OrderType::BUY : OrderType::SELL;
+                 Price price = target->toTicks(priceDist(rng));
+                 int qty = qtyDist(rng);
+                 target->addOrder(Order(order.id + i, type, price, qty, order.timestamp + i));
+             }
+ 
+             auto end = std::chrono::high_resolution_clock::now();
+             std::chrono::duration<double> elapsed = end - start;
+ 
+             double tradesPerSec = target->getTradeCount() / elapsed.count();
+             text << "\nBENCH RESULTS:\n";
+             text << "Orders processed: " << numOrders << "\n";
+             text << "Trades executed: " << target->getTradeCount() << "\n";
+             text << "Elapsed time: " << elapsed.count() << " sec\n";
+             text << "Throughput: " << tradesPerSec << " trades/sec\n";
+         }
+         req.output = text.str();
+         break;
+     }
+     case Kind::Unknown:
+     case Kind::Exit:
+         break;
+     }
+ }
+ 
+ void CliPipeline::encode(const CliRequest &req, std::ostream &out, std::ostream &err)
+ {
+     using Kind = CliRequest::Kind;
+     if (!req.echo)
+         return;
+     out << ">" << req.text << "\n";
+     if (req.unknownSymbol)
+     {
+         err << "Unknown symbol: " << req.output << "\n";
+         return;
+     }
+ 
+     switch (req.kind)
+     {
+     case Kind::Cancel:
+         if (req.valid)
+             out << (req.ok ? "Order cancelled.\n" : "Order not found.\n");
+         break;
+     case Kind::CancelAll:
+     case Kind::CancelRange:
+         out << req.affected << " orders cancelled.\n";
+         break;
+     case Kind::CancelOwner:
+         if (req.valid)
+             out << req.affected << " orders cancelled.\n";
+         break;
+     case Kind::Modify:
+         if (req.valid)
+             out << (req.ok ? "Order modified.\n" : "Order not found.\n");
+         break;
+     case Kind::Time:
+         if (req.valid)
+             out << req.affected << " orders expired.\n";
+         break;
+     case Kind::Uncross:
+         if (req.ok)
+             out << "Uncrossed at $" << req.clearing << "\n";
+         else
+             out << "Nothing to uncross.\n";
+         break;
+     case Kind::Unknown:
+         err << "Unknown command: " << req.command << "\n";
+         break;
+     default:
+         out << req.output;
+         break;
+     }
+ }
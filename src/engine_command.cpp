@@ -0,0 +1,37 @@
+/**
+ * @file engine_command.cpp
+ * @brief Applies queued EngineCommands to a BookManager.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "engine_command.h"
+ #include <cassert>
+ 
+ bool applyCommand(BookManager &books, const EngineCommand &cmd)
+ {
+     switch (cmd.kind)
+     {
+     case EngineCommand::Kind::Intern:
+     {
+         [[maybe_unused]] SymbolId local = books.intern(*cmd.name);
+         assert(local == cmd.symbol);
+         return true;
+     }
+     case EngineCommand::Kind::Add:
+         // book() would throw on this thread for an id the producer never interned
+         if (cmd.symbol >= books.symbolCount())
+             return false;
+         books.addOrder(cmd.symbol, cmd.order);
+         return true;
+     case EngineCommand::Kind::Cancel:
+         return books.cancelOrder(cmd.symbol, cmd.order.id);
+     case EngineCommand::Kind::Modify:
+         return books.modifyOrder(cmd.symbol, cmd.order.id, cmd.order.quantity, cmd.order.price, cmd.order.timestamp);
+     case EngineCommand::Kind::AdvanceTime:
+         books.advanceTime(cmd.order.timestamp);
+         return true;
+     }
+     return true;
+ }
@@ -3,21 +3,34 @@
  * @brief CLI driver for the Limit Order Book (LOB) matching engine.
  *
  * This program provides an interactive command-line interface to the OrderBook.
- * It supports manual commands (BUY, SELL, CANCEL, MODIFY, PRINT, TRADES, EXPORT_BOOK, EXPORT_TRADES),
+ * It supports manual commands (BUY, SELL, CANCEL, MODIFY, TIME, AUCTION, UNCROSS, PRINT, TRADES, EXPORT_BOOK, EXPORT_TRADES),
  * as well as a synthetic benchmark mode (BENCH) for throughput testing.
  *
  * Orders are processed in price-time priority with support for partial fills.
+ * BUY/SELL accept an optional order kind (LIMIT, MARKET, IOC, FOK, STOP,
+ * STOP_LIMIT) followed by an iceberg display size or a stop trigger price,
+ * and a GTT expiry enforced by the TIME command.
+ *
+ * Any command may be prefixed with @SYMBOL to route it to that symbol's book
+ * (e.g. "@AAPL BUY 190.5 10"); unprefixed commands go to the DEFAULT symbol.
+ * A symbol's book is created by its first order (or AUCTION/BENCH); other
+ * commands on a symbol without a book report it unknown. Order IDs are
+ * assigned per symbol.
+ *
+ * Commands run through a CliPipeline: parsing, sequencing, matching and
+ * output each have their own thread, so terminal and file I/O never stall
+ * the matcher. Options:
+ *
+ *     --journal <file>   append every sequenced command to <file> (replayable as input)
+ *     --pin <core>       pin the sequence, match and encode stages to <core>, <core>+1, <core>+2
  *
  * @author Nick Ingargiola
  * @date 2025-08-08
  */
-
- #include "order_book.h"
+ 
+ #include "cli_pipeline.h"
  #include <iostream>
- #include <sstream>
  #include <string>
- #include <chrono>
- #include <random>
  
  /**
   * @brief Program entry point.
@@ -27,128 +40,29 @@
   *
   * @return int Exit code (0 on success).
   */
- int main() {
-     OrderBook book;
- 
-     // Directory for CSV exports
-     book.setExportDir("exports");
- 
-     // Disable CSV auto-export for performance in benchmarks
-     book.setAutoExport(false);
+ int main(int argc, char **argv) {
+     // The streams are only used from the pipeline's stages; unsync for buffered reads
+     std::ios::sync_with_stdio(false);
  
-     long timestamp = 1;  ///< Logical timestamp for order sequencing
-     int nextId = 1;      ///< Incremental order ID counter
+     PipelineConfig config;
+     // IDs come from a per-symbol counter, so they are dense: index them by slot
+     config.book.directOrderIds = true;
  
-     std::string input;
-     while (std::getline(std::cin, input)) {
-         if (input.empty())
-             continue; // Ignore blank lines
- 
-         std::cout << ">" << input << "\n";
-         std::istringstream iss(input);
-         std::string command;
-         iss >> command;
- 
-         // ------------------------------------------------
-         // BUY / SELL: Create a new order
-         // ------------------------------------------------
-         if (command == "BUY" || command == "SELL") {
-             double price;
-             int qty;
-             if (iss >> price >> qty) {
-                 OrderType type = (command == "BUY") ? OrderType::BUY : OrderType::SELL;
-                 book.addOrder(Order(nextId++, type, price, qty, timestamp++));
-             }
-         }
-         // ------------------------------------------------
-         // CANCEL: Remove an existing order by ID
-         // ------------------------------------------------
-         else if (command == "CANCEL") {
-             int id;
-             if (iss >> id)
-                 std::cout << (book.cancelOrder(id) ? "Order cancelled.\n" : "Order not found.\n");
-         }
-         // ------------------------------------------------
-         // MODIFY: Update price/quantity for an order by ID
-         // ------------------------------------------------
-         else if (command == "MODIFY") {
-             int id, qty;
-             double price;
-             if (iss >> id >> qty >> price)
-                 std::cout << (book.modifyOrder(id, qty, price, timestamp++) ? "Order modified.\n" : "Order not found.\n");
-         }
-         // ------------------------------------------------
-         // PRINT: Display the current state of the order book
-         // ------------------------------------------------
-         else if (command == "PRINT") {
-             book.printBook();
-         }
-         // ------------------------------------------------
-         // TRADES: Display executed trades
-         // ------------------------------------------------
-         else if (command == "TRADES") {
-             book.printTrades();
-         }
-         // ------------------------------------------------
-         // EXPORT_BOOK: Save the current order book to CSV
-         // ------------------------------------------------
-         else if (command == "EXPORT_BOOK") {
-             book.exportBookCSV();
-         }
-         // ------------------------------------------------
-         // EXPORT_TRADES: Save executed trades to CSV
-         // ------------------------------------------------
-         else if (command == "EXPORT_TRADES") {
-             book.exportTradesCSV();
-         }
-         // ------------------------------------------------
-         // BENCH: Run synthetic benchmark
-         // BENCH <numOrders>
-         // ------------------------------------------------
-         else if (command == "BENCH") {
-             int numOrders;
-             iss >> numOrders;
-             if (numOrders <= 0) numOrders = 100000;
- 
-             // Fixed RNG seed for repeatability
-             std::mt19937 rng(42);
-             std::uniform_real_distribution<double> priceDist(90.0, 110.0);
-             std::uniform_int_distribution<int> qtyDist(1, 5);
-             std::uniform_int_distribution<int> sideDist(0, 1);
- 
-             auto start = std::chrono::high_resolution_clock::now();
- 
-             for (int i = 0; i < numOrders; i++) {
-                 OrderType type = sideDist(rng) ? OrderType::BUY : OrderType::SELL;
-                 double price = priceDist(rng);
-                 int qty = qtyDist(rng);
-                 book.addOrder(Order(nextId++, type, price, qty, timestamp++));
-             }
- 
-             auto end = std::chrono::high_resolution_clock::now();
-             std::chrono::duration<double> elapsed = end - start;
- 
-             double tradesPerSec = book.getTrades().size() / elapsed.count();
-             std::cout << "\nBENCH RESULTS:\n";
-             std::cout << "Orders processed: " << numOrders << "\n";
-             std::cout << "Trades executed: " << book.getTrades().size() << "\n";
-             std::cout << "Elapsed time: " << elapsed.count() << " sec\n";
-             std::cout << "Throughput: " << tradesPerSec << " trades/sec\n";
-         }
-         // ------------------------------------------------
-         // EXIT: End program
-         // ------------------------------------------------
-         else if (command == "EXIT") {
-             break;
+     for (int i = 1; i < argc; ++i) {
+         std::string arg = argv[i];
+         if (arg == "--journal" && i + 1 < argc)
+             config.journalPath = argv[++i];
+         else if (arg == "--pin" && i + 1 < argc) {
+             config.pinThreads = true;
+             config.firstCore = static_cast<unsigned>(std::stoul(argv[++i]));
          }
-         // ------------------------------------------------
-         // UNKNOWN COMMAND
-         // ------------------------------------------------
          else {
-             std::cerr << "Unknown command: " << command << "\n";
+             std::cerr << "Usage: " << argv[0] << " [--journal <file>] [--pin <core>]\n";
+             return 1;
          }
      }
  
+     CliPipeline pipeline(config);
+     pipeline.run(std::cin, std::cout, std::cerr);
      return 0;
  }
- 
\ No newline at end of file
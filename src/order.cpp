@@ -1,4 +1,4 @@
 #include "order.h"
 
-Order::Order(int id, OrderType type, double price, int quantity, long timestamp)
-    : id(id), type(type), price(price), quantity(quantity), timestamp(timestamp) {}
\ No newline at end of file
+Order::Order(int id, OrderType type, Price price, int quantity, long timestamp, OrderKind kind)
+    : id(id), type(type), price(price), quantity(quantity), timestamp(timestamp), kind(kind) {}
\ No newline at end of file
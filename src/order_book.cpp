@@ -20,6 +20,8 @@
  #include <ctime>
  #include <filesystem>
  #include <atomic>
+ #include <limits>
+ #include <utility>
  
  /// Global atomic counter to generate unique snapshot file names.
  static std::atomic<uint64_t> g_snapshot{0};
@@ -57,19 +59,44 @@
      return (outDir / oss.str()).string();
  }
  
- void OrderBook::setExportDir(const std::string &dir)
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ BasicOrderBook<Ladder, Policy, Sink>::BasicOrderBook(const BookConfig &config)
+     : scale(config.tickSize), bids(config), asks(config), orderIndex(config.directOrderIds),
+       buyStops(config), sellStops(config)
  {
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::setExportDir(const std::string &dir)
+ {
+     // Created on first export, so books that never export touch no files
      exportDir = dir.empty() ? "." : dir;
+ }
  
-     std::error_code ec;
-     std::filesystem::create_directories(exportDir, ec); // Create folder if missing
-     if (ec)
-     {
-         std::cerr << "Warning: Could not create export directory: " << exportDir << "\n";
-     }
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::reserve(std::size_t orders)
+ {
+     pool.reserve(orders);
+     orderIndex.reserve(orders);
  }
  
- void OrderBook::addOrder(const Order &order)
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::addOrder(const Order &order)
+ {
+     submitOrder(order);
+     finishEvent();
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::submitOrder(const Order &order)
+ {
+     placeOrder(order);
+     if (!buyStops.empty() || !sellStops.empty())
+         releaseStops();
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::placeOrder(const Order &order)
  {
      // Validation: ignore invalid orders
      if (order.quantity <= 0)
@@ -78,173 +105,871 @@
          return;
      }
  
-     // Insert into correct side (bids or asks) maintaining list order
-     if (order.type == OrderType::BUY)
+     if (order.expireAt != 0 && order.expireAt <= expiries.now())
      {
-         if (bids.empty() || order.price > bids.front().price)
-             bids.push_front(order), orderIndex[order.id] = {OrderType::BUY, bids.begin()};
+         std::cerr << "Error: Order has already expired.\n";
+         return;
+     }
+ 
+     // Everything below runs in a per-side instantiation; this is the only side branch
+     bool isBuy = order.type == OrderType::BUY;
+     if (order.kind == OrderKind::STOP || order.kind == OrderKind::STOP_LIMIT)
+     {
+         if (isBuy)
+             parkStop<OrderType::BUY>(order);
          else
-             bids.push_back(order), orderIndex[order.id] = {OrderType::BUY, std::prev(bids.end())};
+             parkStop<OrderType::SELL>(order);
+         return;
      }
-     else
+ 
+     // Takers never rest, so they skip the band check and the resting path entirely
+     if (order.kind != OrderKind::LIMIT)
      {
-         if (asks.empty() || order.price < asks.front().price)
-             asks.push_front(order), orderIndex[order.id] = {OrderType::SELL, asks.begin()};
+         if (auction)
+         {
+             std::cerr << "Error: Only limit orders are accepted during an auction.\n";
+             return;
+         }
+         if (isBuy)
+             executeTaker<OrderType::BUY>(order);
          else
-             asks.push_back(order), orderIndex[order.id] = {OrderType::SELL, std::prev(asks.end())};
+             executeTaker<OrderType::SELL>(order);
+         return;
+     }
+ 
+     if (isBuy)
+         placeLimit<OrderType::BUY>(order);
+     else
+         placeLimit<OrderType::SELL>(order);
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ template <OrderType Side>
+ void BasicOrderBook<Ladder, Policy, Sink>::placeLimit(const Order &order)
+ {
+     if (!ladder<Side>().accepts(order.price))
+     {
+         std::cerr << "Error: Order price outside the book's price band.\n";
+         return;
+     }
+ 
+     // Marketable orders trade against the opposite side before they can rest.
+     // During an auction everything rests, crossed or not, until uncross().
+     Order incoming = order;
+     if (!auction)
+     {
+         const PriceLevel *best = ladder<opposite(Side)>().best();
+         if (best && crosses<Side>(incoming.price, best->price))
+         {
+             matchIncoming<Side>(incoming);
+             if (incoming.quantity == 0)
+                 return;
+         }
+     }
+ 
+     // Iceberg: display one slice and hold the rest of the remainder in reserve
+     incoming.hiddenQty = 0;
+     if (incoming.displayQty > 0 && incoming.quantity > incoming.displayQty)
+     {
+         incoming.hiddenQty = incoming.quantity - incoming.displayQty;
+         incoming.quantity = incoming.displayQty;
      }
  
-     // Attempt matching after adding
-     matchOrders();
+     // Rest the remainder at the back of its price level
+     PriceLevel &level = ladder<Side>().insert(incoming.price);
+     OrderHandle h = pool.acquire(incoming);
+     linkOrder(level, h);
+     linkOwner(h);
+     orderIndex.insert(incoming.id, h);
+     if (incoming.expireAt != 0)
+         expiries.schedule(pool, h);
+     sink.onAdd(pool[h].order);
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ template <OrderType Side>
+ void BasicOrderBook<Ladder, Policy, Sink>::parkStop(const Order &order)
+ {
+     PriceLevel &trigger = stops<Side>().insert(order.stopPrice);
+     Order stop = order;
+     stop.hiddenQty = 0;
+     OrderHandle h = pool.acquire(stop);
+     linkOrder(trigger, h);
+     linkOwner(h);
+     orderIndex.insert(stop.id, h);
+     if (stop.expireAt != 0)
+         expiries.schedule(pool, h);
  }
  
- bool OrderBook::modifyOrder(int id, int newQty, double newPrice, long newTimestamp)
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::electStops()
  {
-     auto it = orderIndex.find(id);
-     if (it == orderIndex.end())
+     auto elect = [this](auto &triggers, auto reached) {
+         for (PriceLevel *trigger = triggers.best(); trigger && reached(trigger->price); trigger = triggers.best())
+         {
+             while (!trigger->orders.empty())
+             {
+                 OrderHandle h = trigger->orders.head;
+                 unlinkOrder(*trigger, h);
+                 pool[h].level = nullptr;
+                 pool.pushBack(electedStops, h);
+             }
+             triggers.erase(*trigger);
+         }
+     };
+ 
+     Price last = *lastPrice;
+     elect(buyStops, [last](Price stop) { return stop <= last; });
+     elect(sellStops, [last](Price stop) { return stop >= last; });
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::releaseStops()
+ {
+     if (releasingStops || auction || !lastPrice)
+         return;
+     if (buyStops.empty() && sellStops.empty() && electedStops.empty())
+         return;
+ 
+     releasingStops = true;
+     for (electStops(); !electedStops.empty(); electStops())
+     {
+         // Retire the stop's node, then submit it as its triggered kind
+         OrderHandle h = electedStops.head;
+         Order order = pool[h].order;
+         pool.unlink(electedStops, h);
+         orderIndex.erase(order.id);
+         expiries.cancel(pool, h);
+         unlinkOwner(h);
+         pool.release(h);
+ 
+         order.kind = order.kind == OrderKind::STOP ? OrderKind::MARKET : OrderKind::LIMIT;
+         placeOrder(order);
+     }
+     releasingStops = false;
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ template <OrderType Side>
+ void BasicOrderBook<Ladder, Policy, Sink>::matchIncoming(Order &incoming)
+ {
+     constexpr bool isBuy = Side == OrderType::BUY;
+     auto &resting = ladder<opposite(Side)>();
+ 
+     // Walk the opposite side best-first while the incoming order still crosses
+     while (incoming.quantity > 0)
+     {
+         PriceLevel *level = resting.best();
+         if (!level || !crosses<Side>(incoming.price, level->price))
+             break;
+ 
+         // Trades print at the seller's price; a market sell has none, so it takes the bid
+         Price px = isBuy || incoming.kind == OrderKind::MARKET ? level->price : incoming.price;
+         auto fill = [&](OrderHandle h, int qty) {
+             Order &maker = pool[h].order;
+             if constexpr (isBuy)
+                 executeTrade(incoming, maker, px, qty);
+             else
+                 executeTrade(maker, incoming, px, qty);
+             level->totalQty -= qty;
+             if (maker.quantity == 0)
+                 retireFilled(*level, h);
+         };
+         Policy::allocate(pool, *level, incoming.quantity, fill);
+ 
+         if (level->orders.empty())
+             resting.erase(*level);
+     }
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::addOrders(const Order *orders, std::size_t count)
+ {
+     // Defer per-trade exports to a single snapshot after the packet
+     bool exportAfter = autoExport;
+     std::uint64_t tradesBefore = tradeCount;
+     autoExport = false;
+ 
+     for (std::size_t i = 0; i < count; ++i)
+     {
+         if (i + PrefetchDistance < count)
+         {
+             // The level prefetch is a no-op on MapLadder; only the index half helps there
+             const Order &ahead = orders[i + PrefetchDistance];
+             if (ahead.type == OrderType::BUY)
+                 bids.prefetch(ahead.price);
+             else
+                 asks.prefetch(ahead.price);
+             orderIndex.prefetch(ahead.id);
+         }
+         submitOrder(orders[i]);
+     }
+ 
+     autoExport = exportAfter;
+     if (autoExport && tradeCount != tradesBefore)
+         exportAfterTrades();
+     finishEvent(count);
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ bool BasicOrderBook<Ladder, Policy, Sink>::modifyOrder(int id, int newQty, Price newPrice, long newTimestamp)
+ {
+     OrderHandle h = orderIndex.find(id);
+     if (h == NullHandle)
+     {
+         finishEvent();
          return false;
+     }
+ 
+     Order &order = pool[h].order;
+     int remaining = order.quantity + order.hiddenQty;
  
-     OrderType type = it->second.type;
+     // Fast path: a size reduction at the same price keeps queue priority.
+     // It cannot create a cross, so no matching is needed. Icebergs shed
+     // reserve before any of the displayed slice.
+     if (newPrice == order.price && newQty > 0 && newQty <= remaining)
+     {
+         PriceLevel *level = pool[h].level;
+         int cut = remaining - newQty;
+         int fromHidden = std::min(cut, order.hiddenQty);
+         order.hiddenQty -= fromHidden;
+         level->hiddenQty -= fromHidden;
+         order.quantity -= cut - fromHidden;
+         level->totalQty -= cut - fromHidden;
+         if (order.kind != OrderKind::STOP && order.kind != OrderKind::STOP_LIMIT)
+             sink.onModify(order);
+         finishEvent();
+         return true;
+     }
  
-     // Remove and reinsert with new parameters
-     cancelOrder(id);
-     addOrder(Order(id, type, newPrice, newQty, newTimestamp));
+     // Price change or size increase: remove and reinsert at the back of the queue,
+     // keeping the order's kind, iceberg slice size and stop trigger
+     Order replacement = order;
+     replacement.price = newPrice;
+     replacement.quantity = newQty;
+     replacement.timestamp = newTimestamp;
+     removeOrder(h);
+     submitOrder(replacement);
+     finishEvent();
      return true;
  }
  
- bool OrderBook::cancelOrder(int id)
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ bool BasicOrderBook<Ladder, Policy, Sink>::cancelOrder(int id)
  {
-     auto it = orderIndex.find(id);
-     if (it == orderIndex.end())
+     OrderHandle h = orderIndex.find(id);
+     if (h == NullHandle)
+     {
+         finishEvent();
          return false;
+     }
+ 
+     removeOrder(h);
+     finishEvent();
+     return true;
+ }
  
-     auto [type, orderIt] = it->second;
-     if (type == OrderType::BUY)
-         bids.erase(orderIt);
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::removeOrder(OrderHandle h)
+ {
+     const Order &order = pool[h].order;
+     int id = order.id;
+     OrderType type = order.type;
+     bool isStop = order.kind == OrderKind::STOP || order.kind == OrderKind::STOP_LIMIT;
+     PriceLevel *level = pool[h].level;
+     if (!isStop)
+         sink.onCancel(order);
+     unlinkOrder(*level, h);
+     expiries.cancel(pool, h);
+     unlinkOwner(h);
+     pool.release(h);
+ 
+     // Drop the level (or stop trigger) once its last order leaves
+     if (level->orders.empty())
+     {
+         if (type == OrderType::BUY)
+             eraseLevel<OrderType::BUY>(*level, isStop);
+         else
+             eraseLevel<OrderType::SELL>(*level, isStop);
+     }
+ 
+     orderIndex.erase(id);
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ template <OrderType Side>
+ void BasicOrderBook<Ladder, Policy, Sink>::eraseLevel(PriceLevel &level, bool isStop)
+ {
+     if (isStop)
+         stops<Side>().erase(level);
      else
-         asks.erase(orderIt);
+         ladder<Side>().erase(level);
+ }
  
-     orderIndex.erase(it);
-     return true;
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::size_t BasicOrderBook<Ladder, Policy, Sink>::cancelAll(OrderType side)
+ {
+     return cancelRange(side, std::numeric_limits<Price>::min(), std::numeric_limits<Price>::max());
  }
  
- void OrderBook::matchOrders()
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::size_t BasicOrderBook<Ladder, Policy, Sink>::cancelRange(OrderType side, Price lo, Price hi)
  {
-     // Continue matching as long as best bid >= best ask
-     while (!bids.empty() && !asks.empty() && bids.front().price >= asks.front().price)
+     if (lo > hi)
      {
-         Order &buy = bids.front();
-         Order &sell = asks.front();
+         finishEvent();
+         return 0;
+     }
+     std::size_t canceled = side == OrderType::BUY ? cancelLevels<OrderType::BUY>(lo, hi) : cancelLevels<OrderType::SELL>(lo, hi);
+     finishEvent();
+     return canceled;
+ }
  
-         executeTrade(buy, sell);
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ template <OrderType Side>
+ std::size_t BasicOrderBook<Ladder, Policy, Sink>::cancelLevels(Price lo, Price hi)
+ {
+     // Enter the range at its best edge and drop levels until one falls outside it
+     auto &levels = ladder<Side>();
+     Price from = Side == OrderType::BUY ? hi : lo;
+     std::size_t canceled = 0;
+     for (PriceLevel *level = levels.seek(from); level && level->price >= lo && level->price <= hi; level = levels.seek(from))
+     {
+         canceled += purgeLevel(*level);
+         levels.erase(*level);
+     }
+     return canceled;
+ }
  
-         if (buy.quantity == 0)
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::size_t BasicOrderBook<Ladder, Policy, Sink>::purgeLevel(PriceLevel &level)
+ {
+     std::size_t count = 0;
+     for (OrderHandle h = level.orders.head; h != NullHandle; h = pool[h].next)
+     {
+         const Order &order = pool[h].order;
+         sink.onCancel(order);
+         orderIndex.erase(order.id);
+         expiries.cancel(pool, h);
+         unlinkOwner(h);
+         ++count;
+     }
+ 
+     // The queue is already chained through next, so it goes back to the pool whole.
+     // Aggregates are reset too: dense ladders reuse the level object.
+     pool.releaseAll(level.orders, count);
+     level.totalQty = 0;
+     level.hiddenQty = 0;
+     level.orderCount = 0;
+     level.topOrder = NullHandle;
+     return count;
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::size_t BasicOrderBook<Ladder, Policy, Sink>::cancelByOwner(int owner)
+ {
+     OrderHandle *head = owner != 0 ? owners.find(owner) : nullptr;
+     if (!head)
+     {
+         finishEvent();
+         return 0;
+     }
+ 
+     // removeOrder unlinks each node from the chain, which keeps the saved next valid
+     std::size_t canceled = 0;
+     for (OrderHandle h = *head; h != NullHandle; ++canceled)
+     {
+         OrderHandle next = pool[h].ownerNext;
+         removeOrder(h);
+         h = next;
+     }
+     finishEvent();
+     return canceled;
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::size_t BasicOrderBook<Ladder, Policy, Sink>::advanceTime(long now)
+ {
+     // A clock running backwards (or a negative time) must not reach the unsigned wheel
+     std::size_t expired = 0;
+     if (now >= expiries.now())
+         expired = expiries.advance(pool, now, [this](OrderHandle h) { removeOrder(h); });
+     finishEvent();
+     return expired;
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::startClockAt(long now)
+ {
+     if (now >= expiries.now())
+         expiries.advance(pool, now, [this](OrderHandle h) { removeOrder(h); });
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::size_t BasicOrderBook<Ladder, Policy, Sink>::cancelOrders(const int *ids, std::size_t count)
+ {
+     std::size_t canceled = 0;
+     for (std::size_t i = 0; i < count; ++i)
+     {
+         // Two-stage pipeline: index slots two strides ahead, order nodes one stride ahead
+         if (i + 2 * PrefetchDistance < count)
+             orderIndex.prefetch(ids[i + 2 * PrefetchDistance]);
+         if (i + PrefetchDistance < count)
          {
-             orderIndex.erase(buy.id);
-             bids.pop_front();
+             OrderHandle h = orderIndex.find(ids[i + PrefetchDistance]);
+             if (h != NullHandle)
+                 pool.prefetch(h);
          }
-         if (sell.quantity == 0)
-         {            
-             orderIndex.erase(sell.id);
-             asks.pop_front();
+         OrderHandle h = orderIndex.find(ids[i]);
+         if (h != NullHandle)
+         {
+             removeOrder(h);
+             ++canceled;
          }
      }
+     finishEvent(count);
+     return canceled;
  }
  
- void OrderBook::executeTrade(Order &buy, Order &sell)
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::matchOrders()
  {
-     int qty = std::min(buy.quantity, sell.quantity);
-     double px = sell.price;
-     long t = std::max(buy.timestamp, sell.timestamp);
+     // Sweep level by level as long as best bid >= best ask
+     for (;;)
+     {
+         PriceLevel *bidLevel = bids.best();
+         PriceLevel *askLevel = asks.best();
+         if (!bidLevel || !askLevel || bidLevel->price < askLevel->price)
+             break;
  
-     trades.emplace_back(buy.id, sell.id, px, qty, t);
+         OrderQueue &buyQueue = bidLevel->orders;
+         OrderQueue &sellQueue = askLevel->orders;
  
-     buy.quantity -= qty;
-     sell.quantity -= qty;
-     totalVolumeTraded += qty;
+         // Match FIFO within the two best levels until one of them empties
+         while (!buyQueue.empty() && !sellQueue.empty())
+         {
+             OrderHandle bh = buyQueue.head;
+             OrderHandle sh = sellQueue.head;
+             Order &buy = pool[bh].order;
+             Order &sell = pool[sh].order;
+ 
+             int qty = std::min(buy.quantity, sell.quantity);
+             executeTrade(buy, sell, sell.price, qty);
+             bidLevel->totalQty -= qty;
+             askLevel->totalQty -= qty;
+ 
+             if (buy.quantity == 0)
+                 retireFilled(*bidLevel, bh);
+             if (sell.quantity == 0)
+                 retireFilled(*askLevel, sh);
+         }
  
-     if (autoExport)
-     {
-         exportTradesCSV();
-         exportBookCSV();
+         if (buyQueue.empty())
+             bids.erase(*bidLevel);
+         if (sellQueue.empty())
+             asks.erase(*askLevel);
      }
+ 
+     releaseStops();
+     finishEvent();
  }
  
- void OrderBook::printTrades() const
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::setAuctionMode(bool on)
  {
-     std::cout << "\nTrades:\n";
-     for (const auto &trade : trades)
+     // Continuous matching assumes an uncrossed book, so clear the auction on exit
+     bool leaving = auction && !on;
+     auction = on;
+     if (leaving)
+         uncross();  // Counts as this call's event
+     else
+         finishEvent();
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::optional<Price> BasicOrderBook<Ladder, Policy, Sink>::indicativePrice() const
+ {
+     std::int64_t volume = 0;
+     return clearingPrice(volume);
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::optional<Price> BasicOrderBook<Ladder, Policy, Sink>::clearingPrice(std::int64_t &volume) const
+ {
+     volume = 0;
+     const PriceLevel *bestBidLevel = bids.best();
+     const PriceLevel *bestAskLevel = asks.best();
+     if (!bestBidLevel || !bestAskLevel || bestBidLevel->price < bestAskLevel->price)
+         return std::nullopt;
+     Price hiBid = bestBidLevel->price;
+     Price loAsk = bestAskLevel->price;
+ 
+     // Levels inside the crossed range [loAsk, hiBid], as (price, displayed + hidden quantity)
+     std::vector<std::pair<Price, std::int64_t>> bidLevels, askLevels;
+     std::int64_t crossedDemand = 0;
+     bids.forEachWhile([&](const PriceLevel &level) {
+         if (level.price < loAsk)
+             return false;
+         bidLevels.emplace_back(level.price, level.totalQty + level.hiddenQty);
+         crossedDemand += level.totalQty + level.hiddenQty;
+         return true;
+     });
+     asks.forEachWhile([&](const PriceLevel &level) {
+         if (level.price > hiBid)
+             return false;
+         askLevels.emplace_back(level.price, level.totalQty + level.hiddenQty);
+         return true;
+     });
+ 
+     // Sweep candidate prices upwards. Supply(p) = asks at or below p, demand(p) = bids at or above p.
+     std::vector<Price> candidates;
+     std::int64_t bestVolume = -1, bestImbalance = 0;
+     std::int64_t supply = 0, demand = crossedDemand;
+     std::size_t a = 0, b = bidLevels.size();
+     while (a < askLevels.size() || b > 0)
      {
-         std::cout << "Buy ID: " << trade.buyId
-                   << ", Sell ID: " << trade.sellId
-                   << ", Price: $" << trade.price
-                   << ", Quantity: " << trade.quantity
-                   << ", Timestamp: " << trade.timestamp << "\n";
+         Price p = b == 0 || (a < askLevels.size() && askLevels[a].first < bidLevels[b - 1].first)
+                       ? askLevels[a].first
+                       : bidLevels[b - 1].first;
+         while (a < askLevels.size() && askLevels[a].first == p)
+             supply += askLevels[a++].second;
+ 
+         std::int64_t executable = std::min(supply, demand);
+         std::int64_t imbalance = supply > demand ? supply - demand : demand - supply;
+         if (executable > bestVolume || (executable == bestVolume && imbalance < bestImbalance))
+         {
+             bestVolume = executable;
+             bestImbalance = imbalance;
+             candidates.assign(1, p);
+         }
+         else if (executable == bestVolume && imbalance == bestImbalance)
+         {
+             candidates.push_back(p);
+         }
+ 
+         // Bids at p still count at p; they drop out of demand for higher prices
+         while (b > 0 && bidLevels[b - 1].first == p)
+             demand -= bidLevels[--b].second;
      }
+ 
+     volume = bestVolume;
+     // Remaining ties resolve to the middle candidate of the tied range
+     return candidates[(candidates.size() - 1) / 2];
  }
  
- void OrderBook::printBook() const
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::optional<Price> BasicOrderBook<Ladder, Policy, Sink>::uncross()
  {
-     std::cout << "\nOrder Book:\n";
+     std::int64_t volume = 0;
+     std::optional<Price> price = clearingPrice(volume);
+     if (!price)
+     {
+         finishEvent();
+         return std::nullopt;
+     }
+     Price px = *price;
  
-     std::cout << "BIDS:\n";
-     if (!bids.empty()) {
-         double current = bids.front().price;
-         int count = 0;
-         int totalQty = 0;
-         for (const auto& o : bids) {
-             if (o.price != current) {
-                 std::cout << " $" << current << " x " << count << " orders, totalQty=" << totalQty << "\n";
-                 current = o.price; count = 0; totalQty = 0;
+     // Pair eligible orders in price-time priority; every fill prints at px.
+     // Level totals are settled once per level instead of once per fill.
+     std::int64_t bidTaken = 0, askTaken = 0;
+     for (;;)
+     {
+         PriceLevel *bidLevel = bids.best();
+         PriceLevel *askLevel = asks.best();
+         if (!bidLevel || !askLevel || bidLevel->price < px || askLevel->price > px)
+             break;
+ 
+         OrderHandle bh = bidLevel->orders.head;
+         OrderHandle sh = askLevel->orders.head;
+         Order &buy = pool[bh].order;
+         Order &sell = pool[sh].order;
+ 
+         int qty = std::min(buy.quantity, sell.quantity);
+         lastQty = qty;
+         lastTradeTime = std::max(buy.timestamp, sell.timestamp);
+         sink.onTrade(Trade(buy.id, sell.id, px, qty, lastTradeTime));
+         ++tradeCount;
+         buy.quantity -= qty;
+         sell.quantity -= qty;
+         bidTaken += qty;
+         askTaken += qty;
+ 
+         if (buy.quantity == 0)
+         {
+             retireFilled(*bidLevel, bh);
+             if (bidLevel->orders.empty())
+             {
+                 bids.erase(*bidLevel);
+                 bidTaken = 0;
              }
-             ++count; totalQty += o.quantity;
          }
-         std::cout << " $" << current << " x " << count << " orders, totalQty=" << totalQty << "\n";
-     }
- 
-     std::cout << "ASKS:\n";
-     if (!asks.empty()) {
-         double current = asks.front().price;
-         int count = 0;
-         int totalQty = 0;
-         for (const auto& o : asks) {
-             if (o.price != current) {
-                 std::cout << " $" << current << " x " << count << " orders, totalQty=" << totalQty << "\n";
-                 current = o.price; count = 0; totalQty = 0;
+         if (sell.quantity == 0)
+         {
+             retireFilled(*askLevel, sh);
+             if (askLevel->orders.empty())
+             {
+                 asks.erase(*askLevel);
+                 askTaken = 0;
              }
-             ++count; totalQty += o.quantity;
          }
-         std::cout << " $" << current << " x " << count << " orders, totalQty=" << totalQty << "\n";
      }
  
-     std::cout << "Total Volume Traded: " << totalVolumeTraded << " units\n";
+     // At most one partially consumed level remains on each side
+     if (PriceLevel *level = bids.best())
+         level->totalQty -= bidTaken;
+     if (PriceLevel *level = asks.best())
+         level->totalQty -= askTaken;
+ 
+     totalVolumeTraded += static_cast<int>(volume);
+     lastPrice = px;
+     if (autoExport && volume > 0)
+         exportAfterTrades();
+ 
+     releaseStops();
+     finishEvent();
+     return px;
  }
  
- void OrderBook::exportTradesCSV(const std::string &baseName) const
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ template <OrderType Side>
+ void BasicOrderBook<Ladder, Policy, Sink>::executeTaker(const Order &order)
  {
-     std::string filename = makeTimestampedFilename(exportDir, baseName);
+     Order taker = order;
  
-     std::ofstream out(filename);
-     if (!out.is_open())
+     // A market order crosses every level on the opposite side
+     if (taker.kind == OrderKind::MARKET)
+         taker.price = Side == OrderType::BUY ? std::numeric_limits<Price>::max() : std::numeric_limits<Price>::min();
+ 
+     if (taker.kind == OrderKind::FOK && !canFill<Side>(taker))
+         return;
+ 
+     matchIncoming<Side>(taker);
+     // Any residual in taker.quantity is discarded
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ template <OrderType Side>
+ bool BasicOrderBook<Ladder, Policy, Sink>::canFill(const Order &order) const
+ {
+     std::int64_t available = 0;
+     ladder<opposite(Side)>().forEachWhile([&](const PriceLevel &level) {
+         bool reached = crosses<Side>(order.price, level.price);
+         if (reached)
+             available += level.totalQty + level.hiddenQty;
+         return reached && available < order.quantity;
+     });
+     return available >= order.quantity;
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::linkOrder(PriceLevel &level, OrderHandle h)
+ {
+     pool[h].level = &level;
+     if (level.orderCount == 0)
+         level.topOrder = h;
+     pool.pushBack(level.orders, h);
+     level.totalQty += pool[h].order.quantity;
+     level.hiddenQty += pool[h].order.hiddenQty;
+     ++level.orderCount;
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::linkOwner(OrderHandle h)
+ {
+     OrderNode &node = pool[h];
+     int owner = node.order.owner;
+     if (owner == 0)
+         return;
+ 
+     // Newest order first; the map holds the chain head
+     OrderHandle *head = owners.find(owner);
+     node.ownerPrev = NullHandle;
+     node.ownerNext = head ? *head : NullHandle;
+     if (head)
      {
-         std::cerr << "Error: Could not open file " << filename << "\n";
+         pool[*head].ownerPrev = h;
+         *head = h;
+     }
+     else
+     {
+         owners.insert(owner, h);
+     }
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::unlinkOwner(OrderHandle h)
+ {
+     const OrderNode &node = pool[h];
+     int owner = node.order.owner;
+     if (owner == 0)
+         return;
+ 
+     if (node.ownerNext != NullHandle)
+         pool[node.ownerNext].ownerPrev = node.ownerPrev;
+     if (node.ownerPrev != NullHandle)
+         pool[node.ownerPrev].ownerNext = node.ownerNext;
+     else if (node.ownerNext != NullHandle)
+         *owners.find(owner) = node.ownerNext;
+     else
+         owners.erase(owner);
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::unlinkOrder(PriceLevel &level, OrderHandle h)
+ {
+     pool.unlink(level.orders, h);
+     if (level.topOrder == h)
+         level.topOrder = NullHandle;
+     level.totalQty -= pool[h].order.quantity;
+     level.hiddenQty -= pool[h].order.hiddenQty;
+     --level.orderCount;
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::retireFilled(PriceLevel &level, OrderHandle h)
+ {
+     Order &order = pool[h].order;
+ 
+     // Iceberg: show the next slice from the reserve and requeue it behind the level
+     if (order.hiddenQty > 0)
+     {
+         int slice = std::min(order.displayQty, order.hiddenQty);
+         order.hiddenQty -= slice;
+         order.quantity = slice;
+         level.hiddenQty -= slice;
+         level.totalQty += slice;
+         if (level.topOrder == h)
+             level.topOrder = NullHandle;
+         if (pool[h].next != NullHandle)
+         {
+             pool.unlink(level.orders, h);
+             pool.pushBack(level.orders, h);
+         }
          return;
      }
  
-     out << "timestamp,buyId,sellId,price,quantity\n";
-     for (const auto &trade : trades)
+     orderIndex.erase(order.id);
+     unlinkOrder(level, h);
+     expiries.cancel(pool, h);
+     unlinkOwner(h);
+     pool.release(h);
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ std::optional<LevelInfo> BasicOrderBook<Ladder, Policy, Sink>::getLevel(OrderType side, Price price) const
+ {
+     const PriceLevel *level = side == OrderType::BUY ? bids.find(price) : asks.find(price);
+     if (!level)
+         return std::nullopt;
+     return LevelInfo{level->price, level->totalQty, level->orderCount, level->totalQty + level->hiddenQty};
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::executeTrade(Order &buy, Order &sell, Price px, int qty)
+ {
+     long t = std::max(buy.timestamp, sell.timestamp);
+ 
+     sink.onTrade(Trade(buy.id, sell.id, px, qty, t));
+     ++tradeCount;
+ 
+     buy.quantity -= qty;
+     sell.quantity -= qty;
+     totalVolumeTraded += qty;
+     lastPrice = px;
+     lastQty = qty;
+     lastTradeTime = t;
+ 
+     if (autoExport)
+         exportAfterTrades();
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::exportAfterTrades() const
+ {
+     if constexpr (HasTradeHistory<Sink>::value)
+         exportTradesCSV();
+     exportBookCSV();
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::printTrades(std::ostream &out) const
+ {
+     if constexpr (!HasTradeHistory<Sink>::value)
+     {
+         std::cerr << "Error: This book's event sink keeps no trade history.\n";
+     }
+     else
+     {
+         out << "\nTrades:\n";
+         for (const auto &trade : sink.trades())
+         {
+             out << "Buy ID: " << trade.buyId
+                 << ", Sell ID: " << trade.sellId
+                 << ", Price: $" << toPrice(trade.price)
+                 << ", Quantity: " << trade.quantity
+                 << ", Timestamp: " << trade.timestamp << "\n";
+         }
+     }
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::printBook(std::ostream &out) const
+ {
+     out << "\nOrder Book:\n";
+ 
+     auto printLevel = [this, &out](const LevelInfo &level) {
+         out << " $" << toPrice(level.price) << " x " << level.orders << " orders, totalQty=" << level.quantity;
+         if (level.total != level.quantity)
+             out << " (+" << level.total - level.quantity << " hidden)";
+         out << "\n";
+     };
+     const std::size_t allLevels = std::numeric_limits<std::size_t>::max();
+ 
+     out << "BIDS:\n";
+     forEachLevel(OrderType::BUY, allLevels, printLevel);
+ 
+     out << "ASKS:\n";
+     forEachLevel(OrderType::SELL, allLevels, printLevel);
+ 
+     out << "Total Volume Traded: " << totalVolumeTraded << " units\n";
+ }
+ 
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::exportTradesCSV(const std::string &baseName, std::ostream &log) const
+ {
+     if constexpr (!HasTradeHistory<Sink>::value)
      {
-         out << trade.timestamp << ","
-             << trade.buyId << ","
-             << trade.sellId << ","
-             << trade.price << ","
-             << trade.quantity << "\n";
+         (void)baseName;
+         (void)log;
+         std::cerr << "Error: This book's event sink keeps no trade history.\n";
      }
+     else
+     {
+         std::string filename = makeTimestampedFilename(exportDir, baseName);
+ 
+         std::ofstream out(filename);
+         if (!out.is_open())
+         {
+             std::cerr << "Error: Could not open file " << filename << "\n";
+             return;
+         }
  
-     std::cout << "Trades exported to " << filename << "\n";
+         out << "timestamp,buyId,sellId,price,quantity\n";
+         for (const auto &trade : sink.trades())
+         {
+             out << trade.timestamp << ","
+                 << trade.buyId << ","
+                 << trade.sellId << ","
+                 << toPrice(trade.price) << ","
+                 << trade.quantity << "\n";
+         }
+ 
+         log << "Trades exported to " << filename << "\n";
+     }
  }
  
- void OrderBook::exportBookCSV(const std::string &baseName) const
+ template <template <OrderType> class Ladder, typename Policy, typename Sink>
+ void BasicOrderBook<Ladder, Policy, Sink>::exportBookCSV(const std::string &baseName, std::ostream &log) const
  {
      std::string filename = makeTimestampedFilename(exportDir, baseName);
      std::ofstream out(filename);
@@ -255,12 +980,31 @@
  
      out << "side,price,quantity,id,timestamp\n";
  
-     for (const auto& o : asks)
-         out << "SELL," << o.price << "," << o.quantity << "," << o.id << "," << o.timestamp << "\n";
+     asks.forEach([&](const PriceLevel& level) {
+         for (OrderHandle h = level.orders.head; h != NullHandle; h = pool[h].next) {
+             const Order& o = pool[h].order;
+             out << "SELL," << toPrice(o.price) << "," << o.quantity << "," << o.id << "," << o.timestamp << "\n";
+         }
+     });
  
-     for (const auto& o : bids)
-         out << "BUY," << o.price << "," << o.quantity << "," << o.id << "," << o.timestamp << "\n";
+     bids.forEach([&](const PriceLevel& level) {
+         for (OrderHandle h = level.orders.head; h != NullHandle; h = pool[h].next) {
+             const Order& o = pool[h].order;
+             out << "BUY," << toPrice(o.price) << "," << o.quantity << "," << o.id << "," << o.timestamp << "\n";
+         }
+     });
  
-     std::cout << "Order book exported to " << filename << "\n";
+     log << "Order book exported to " << filename << "\n";
  }
- 
\ No newline at end of file
+ 
+ // Explicit instantiations for the supported ladder backends, allocation policies and event sinks
+ template class BasicOrderBook<MapLadder, FifoPolicy, TradeLog>;
+ template class BasicOrderBook<MapLadder, ProRataPolicy, TradeLog>;
+ template class BasicOrderBook<MapLadder, TopOrderPolicy<ProRataPolicy>, TradeLog>;
+ template class BasicOrderBook<MapLadder, FifoPolicy, NullSink>;
+ template class BasicOrderBook<MapLadder, FifoPolicy, CallbackSink>;
+ template class BasicOrderBook<DenseLadder, FifoPolicy, TradeLog>;
+ template class BasicOrderBook<DenseLadder, ProRataPolicy, TradeLog>;
+ template class BasicOrderBook<DenseLadder, TopOrderPolicy<ProRataPolicy>, TradeLog>;
+ template class BasicOrderBook<DenseLadder, FifoPolicy, NullSink>;
+ template class BasicOrderBook<DenseLadder, FifoPolicy, CallbackSink>;
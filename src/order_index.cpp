@@ -0,0 +1,88 @@
+/**
+ * @file order_index.cpp
+ * @brief Window management for the direct-indexed OrderIndex.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "order_index.h"
+ #include <algorithm>
+ 
+ void OrderIndex::reserve(std::size_t orders)
+ {
+     if (!directMode)
+     {
+         sparse.reserve(orders);
+         return;
+     }
+ 
+     std::size_t newSize = std::max(ring.size(), InitialWindow);
+     while (newSize < orders && newSize < MaxWindow)
+         newSize *= 2;
+     if (newSize != ring.size())
+         resize(newSize);
+ }
+ 
+ void OrderIndex::insertSlow(int id, OrderHandle h)
+ {
+     if (!directMode)
+     {
+         sparse.insert(id, h);
+         return;
+     }
+ 
+     // Empty window: (re)start it at this ID
+     if (ring.empty() || directCount == 0)
+     {
+         if (ring.empty())
+             ring.assign(InitialWindow, NullHandle);
+         base = top = id;
+         insert(id, h);
+         return;
+     }
+ 
+     // Stale IDs, or jumps wider than the window, are not part of the dense sequence
+     if (id < base || id - top >= static_cast<long long>(ring.size()))
+     {
+         sparse.insert(id, h);
+         return;
+     }
+ 
+     // Grow the ring to cover [base, id] while under the cap
+     long long span = static_cast<long long>(id) - base + 1;
+     std::size_t newSize = ring.size();
+     while (static_cast<long long>(newSize) < span && newSize < MaxWindow)
+         newSize *= 2;
+     if (newSize != ring.size())
+         resize(newSize);
+ 
+     // At the cap: slide the base forward, moving long-lived stragglers to the hash index
+     if (span > static_cast<long long>(ring.size()))
+     {
+         long long newBase = static_cast<long long>(id) + 1 - static_cast<long long>(ring.size());
+         for (long long i = base; i < newBase && i < top; ++i)
+         {
+             OrderHandle &cell = ring[slot(i)];
+             if (cell != NullHandle)
+             {
+                 sparse.insert(static_cast<int>(i), cell);
+                 cell = NullHandle;
+                 --directCount;
+             }
+         }
+         base = newBase;
+         if (top < base)
+             top = base;
+     }
+ 
+     insert(id, h);
+ }
+ 
+ void OrderIndex::resize(std::size_t newSize)
+ {
+     std::vector<OrderHandle> grown(newSize, NullHandle);
+     for (long long i = base; i < top; ++i)
+         grown[static_cast<std::size_t>(static_cast<unsigned long long>(i)) & (newSize - 1)] = ring[slot(i)];
+     ring.swap(grown);
+ }
@@ -0,0 +1,21 @@
+/**
+ * @file order_pool.cpp
+ * @brief Out-of-line growth paths for the OrderPool slab allocator.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "order_pool.h"
+ 
+ void OrderPool::reserve(std::size_t nodes)
+ {
+     chunks.reserve((nodes + ChunkSize - 1) / ChunkSize);
+     while (capacity() < nodes)
+         grow();
+ }
+ 
+ void OrderPool::grow()
+ {
+     chunks.emplace_back(new OrderNode[ChunkSize]);
+ }
@@ -0,0 +1,126 @@
+/**
+ * @file sequenced_engine.cpp
+ * @brief Request sequencing and the matching thread loop of the SequencedEngine.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "sequenced_engine.h"
+ #include "thread_affinity.h"
+ 
+ /// Empty polls the matching thread spins through before yielding its core.
+ static constexpr unsigned SpinsBeforeYield = 256;
+ 
+ SequencedEngine::SequencedEngine(const SequencerConfig &queue, const BookConfig &config)
+     : scale(config.tickSize), sequencer(queue.capacity), books(config)
+ {
+     books.setAutoExport(queue.autoExport);
+     books.setExportDir(queue.exportDir);
+     matcher = std::thread([this] { run(); });
+     if (queue.pinThread)
+         pinned = pinToCore(matcher, queue.core);
+ }
+ 
+ SequencedEngine::~SequencedEngine()
+ {
+     stop();
+ }
+ 
+ SymbolId SequencedEngine::intern(const std::string &symbol)
+ {
+     const std::size_t before = symbols.size();
+     SymbolId id = symbols.intern(symbol);
+     if (symbols.size() != before)
+     {
+         EngineCommand cmd;
+         cmd.kind = EngineCommand::Kind::Intern;
+         cmd.symbol = id;
+         cmd.name = &symbols.name(id);
+         sequencer.publish(std::move(cmd));
+     }
+     return id;
+ }
+ 
+ std::uint64_t SequencedEngine::addOrder(SymbolId id, const Order &order)
+ {
+     EngineCommand cmd;
+     cmd.kind = EngineCommand::Kind::Add;
+     cmd.symbol = id;
+     cmd.order = order;
+     return sequencer.publish(std::move(cmd));
+ }
+ 
+ std::uint64_t SequencedEngine::cancelOrder(SymbolId id, int orderId)
+ {
+     EngineCommand cmd;
+     cmd.kind = EngineCommand::Kind::Cancel;
+     cmd.symbol = id;
+     cmd.order.id = orderId;
+     return sequencer.publish(std::move(cmd));
+ }
+ 
+ std::uint64_t SequencedEngine::modifyOrder(SymbolId id, int orderId, int newQty, Price newPrice)
+ {
+     EngineCommand cmd;
+     cmd.kind = EngineCommand::Kind::Modify;
+     cmd.symbol = id;
+     cmd.order.id = orderId;
+     cmd.order.quantity = newQty;
+     cmd.order.price = newPrice;
+     return sequencer.publish(std::move(cmd));
+ }
+ 
+ std::uint64_t SequencedEngine::advanceTime(long now)
+ {
+     EngineCommand cmd;
+     cmd.kind = EngineCommand::Kind::AdvanceTime;
+     cmd.order.timestamp = now;
+     return sequencer.publish(std::move(cmd));
+ }
+ 
+ void SequencedEngine::drain()
+ {
+     const std::uint64_t target = sequencer.claimed();
+     while (applied.load(std::memory_order_acquire) < target)
+         std::this_thread::yield();
+ }
+ 
+ void SequencedEngine::stop()
+ {
+     if (stopped)
+         return;
+     drain();
+     stopping.store(true, std::memory_order_release);
+     matcher.join();
+     stopped = true;
+ }
+ 
+ void SequencedEngine::run()
+ {
+     EngineCommand cmd;
+     std::uint64_t seq = 0;
+     unsigned idle = 0;
+     while (true)
+     {
+         if (sequencer.tryConsume(cmd, seq))
+         {
+             // The sequence number is the priority clock, as timestamp++ is in the CLI
+             if (cmd.kind == EngineCommand::Kind::Add || cmd.kind == EngineCommand::Kind::Modify)
+                 cmd.order.timestamp = static_cast<long>(seq + 1);
+             if (!applyCommand(books, cmd))
+                 ++rejected;
+             applied.store(seq + 1, std::memory_order_release);
+             idle = 0;
+         }
+         else if (stopping.load(std::memory_order_acquire))
+         {
+             return;  // stop() drained first, so nothing is left behind
+         }
+         else if (++idle >= SpinsBeforeYield)
+         {
+             idle = 0;
+             std::this_thread::yield();
+         }
+     }
+ }
@@ -0,0 +1,162 @@
+/**
+ * @file sharded_engine.cpp
+ * @brief Worker threads, core pinning and command routing for the ShardedEngine.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "sharded_engine.h"
+ #include "thread_affinity.h"
+ #include <cassert>
+ 
+ /// Empty polls a worker spins through before yielding its core.
+ static constexpr unsigned SpinsBeforeYield = 256;
+ 
+ ShardedEngine::ShardedEngine(const ShardConfig &shards, const BookConfig &books)
+     : scale(books.tickSize)
+ {
+     const std::size_t count = shards.workers > 0 ? shards.workers : 1;
+ 
+     workers.reserve(count);
+     for (std::size_t w = 0; w < count; ++w)
+     {
+         workers.push_back(std::make_unique<Worker>(shards.queueCapacity, books));
+         workers.back()->books.setAutoExport(shards.autoExport);
+         workers.back()->books.setExportDir(shards.exportDir);
+     }
+ 
+     // Start only once every worker exists, so a thread never sees a half-built vector
+     for (std::size_t w = 0; w < count; ++w)
+     {
+         Worker &worker = *workers[w];
+         worker.thread = std::thread([this, &worker] { run(worker); });
+         if (shards.pinThreads)
+             worker.pinned = pinToCore(worker.thread, static_cast<unsigned>(shards.firstCore + w));
+     }
+ }
+ 
+ ShardedEngine::~ShardedEngine()
+ {
+     stop();
+ }
+ 
+ SymbolId ShardedEngine::intern(const std::string &symbol)
+ {
+     const std::size_t before = symbols.size();
+     SymbolId id = symbols.intern(symbol);
+     if (symbols.size() != before)
+     {
+         // The worker interns the same name; ids arrive in order, so its local id is id / workers
+         EngineCommand cmd;
+         cmd.kind = EngineCommand::Kind::Intern;
+         cmd.name = &symbols.name(id);
+         route(id, std::move(cmd));
+     }
+     return id;
+ }
+ 
+ void ShardedEngine::addOrder(SymbolId id, const Order &order)
+ {
+     EngineCommand cmd;
+     cmd.kind = EngineCommand::Kind::Add;
+     cmd.order = order;
+     route(id, std::move(cmd));
+ }
+ 
+ void ShardedEngine::cancelOrder(SymbolId id, int orderId)
+ {
+     EngineCommand cmd;
+     cmd.kind = EngineCommand::Kind::Cancel;
+     cmd.order.id = orderId;
+     route(id, std::move(cmd));
+ }
+ 
+ void ShardedEngine::modifyOrder(SymbolId id, int orderId, int newQty, Price newPrice, long newTimestamp)
+ {
+     EngineCommand cmd;
+     cmd.kind = EngineCommand::Kind::Modify;
+     cmd.order.id = orderId;
+     cmd.order.quantity = newQty;
+     cmd.order.price = newPrice;
+     cmd.order.timestamp = newTimestamp;
+     route(id, std::move(cmd));
+ }
+ 
+ void ShardedEngine::advanceTime(long now)
+ {
+     for (std::size_t w = 0; w < workers.size(); ++w)
+     {
+         EngineCommand cmd;
+         cmd.kind = EngineCommand::Kind::AdvanceTime;
+         cmd.order.timestamp = now;
+         push(w, std::move(cmd));
+     }
+ }
+ 
+ void ShardedEngine::drain()
+ {
+     for (auto &worker : workers)
+         while (worker->processed.load(std::memory_order_acquire) < worker->submitted)
+             std::this_thread::yield();
+ }
+ 
+ void ShardedEngine::stop()
+ {
+     if (stopped)
+         return;
+     drain();
+     stopping.store(true, std::memory_order_release);
+     for (auto &worker : workers)
+         worker->thread.join();
+     stopped = true;
+ }
+ 
+ std::uint64_t ShardedEngine::rejectedCount() const
+ {
+     std::uint64_t total = 0;
+     for (const auto &worker : workers)
+         total += worker->rejected;
+     return total;
+ }
+ 
+ void ShardedEngine::push(std::size_t w, EngineCommand &&cmd)
+ {
+     Worker &worker = *workers[w];
+     assert(!stopped);
+     while (!worker.inbox.tryPush(std::move(cmd)))
+         std::this_thread::yield();  // Ring full: the worker is behind, let it run
+     ++worker.submitted;
+ }
+ 
+ void ShardedEngine::route(SymbolId id, EngineCommand &&cmd)
+ {
+     const SymbolId n = static_cast<SymbolId>(workers.size());
+     cmd.symbol = id / n;
+     push(id % n, std::move(cmd));
+ }
+ 
+ void ShardedEngine::run(Worker &worker)
+ {
+     EngineCommand cmd;
+     unsigned idle = 0;
+     while (true)
+     {
+         if (worker.inbox.tryPop(cmd))
+         {
+             if (!applyCommand(worker.books, cmd))
+                 ++worker.rejected;
+             worker.processed.store(worker.processed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+             idle = 0;
+         }
+         else if (stopping.load(std::memory_order_acquire))
+         {
+             return;  // stop() drained first, so nothing is left behind
+         }
+         else if (++idle >= SpinsBeforeYield)
+         {
+             idle = 0;
+             std::this_thread::yield();
+         }
+     }
+ }
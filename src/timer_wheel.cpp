@@ -0,0 +1,132 @@
+/**
+ * @file timer_wheel.cpp
+ * @brief Slot placement, cascading and next-event search for the TimerWheel.
+ *
+ * @author Nick Ingargiola
+ * @date 2025-08-08
+ */
+ 
+ #include "timer_wheel.h"
+ 
+ #ifdef _MSC_VER
+ #include <intrin.h>
+ #endif
+ 
+ /// @brief Index of the lowest set bit of a non-zero word.
+ static unsigned lowestBit(std::uint64_t x)
+ {
+ #ifdef _MSC_VER
+     unsigned long idx;
+     _BitScanForward64(&idx, x);
+     return idx;
+ #else
+     return static_cast<unsigned>(__builtin_ctzll(x));
+ #endif
+ }
+ 
+ void TimerWheel::place(OrderPool &pool, OrderHandle h)
+ {
+     // Overdue entries expire at the current time, on the next advance
+     std::uint64_t t = static_cast<std::uint64_t>(pool[h].order.expireAt);
+     if (t < current)
+         t = current;
+ 
+     std::uint64_t diff = t ^ current;
+     if (diff >> SpanBits)
+     {
+         link(pool, h, OverflowSlot);
+         return;
+     }
+ 
+     // Level = highest 6-bit group in which the expiry differs from now
+     unsigned level = 0;
+     while (level + 1 < Levels && (diff >> ((level + 1) * SlotBits)) != 0)
+         ++level;
+     link(pool, h, level * Slots + static_cast<std::uint32_t>((t >> (level * SlotBits)) & SlotMask));
+ }
+ 
+ void TimerWheel::link(OrderPool &pool, OrderHandle h, std::uint32_t slot)
+ {
+     OrderNode &node = pool[h];
+     node.timerSlot = slot;
+     node.timerPrev = NullHandle;
+     node.timerNext = heads[slot];
+     if (heads[slot] != NullHandle)
+         pool[heads[slot]].timerPrev = h;
+     heads[slot] = h;
+     if (slot != OverflowSlot)
+         occupied[slot / Slots] |= std::uint64_t{1} << (slot % Slots);
+ }
+ 
+ void TimerWheel::unlink(OrderPool &pool, OrderHandle h)
+ {
+     OrderNode &node = pool[h];
+     std::uint32_t slot = node.timerSlot;
+     if (node.timerPrev != NullHandle)
+         pool[node.timerPrev].timerNext = node.timerNext;
+     else
+         heads[slot] = node.timerNext;
+     if (node.timerNext != NullHandle)
+         pool[node.timerNext].timerPrev = node.timerPrev;
+ 
+     if (heads[slot] == NullHandle && slot != OverflowSlot)
+         occupied[slot / Slots] &= ~(std::uint64_t{1} << (slot % Slots));
+     node.timerSlot = NoTimerSlot;
+ }
+ 
+ void TimerWheel::cascadeAt(OrderPool &pool, std::uint64_t t)
+ {
+     // Detach the whole list first: re-placed entries may land back in the overflow list
+     auto replace = [&](std::uint32_t slot) {
+         OrderHandle h = heads[slot];
+         heads[slot] = NullHandle;
+         if (slot != OverflowSlot)
+             occupied[slot / Slots] &= ~(std::uint64_t{1} << (slot % Slots));
+         while (h != NullHandle)
+         {
+             OrderHandle next = pool[h].timerNext;
+             place(pool, h);
+             h = next;
+         }
+     };
+ 
+     if (heads[OverflowSlot] != NullHandle && (t & ((std::uint64_t{1} << SpanBits) - 1)) == 0)
+         replace(OverflowSlot);
+ 
+     // Highest level first, so entries can fall through several levels at once
+     for (unsigned level = Levels - 1; level >= 1; --level)
+     {
+         unsigned shift = level * SlotBits;
+         if (t & ((std::uint64_t{1} << shift) - 1))
+             continue;
+         std::uint32_t s = static_cast<std::uint32_t>((t >> shift) & SlotMask);
+         if (occupied[level] & (std::uint64_t{1} << s))
+             replace(level * Slots + s);
+     }
+ }
+ 
+ bool TimerWheel::nextEvent(std::uint64_t &t) const
+ {
+     bool found = false;
+     for (unsigned level = 0; level < Levels; ++level)
+     {
+         if (!occupied[level])
+             continue;
+         // Occupied slots always lie ahead of the current slot at their level
+         unsigned shift = level * SlotBits;
+         std::uint64_t base = (current >> (shift + SlotBits)) << (shift + SlotBits);
+         std::uint64_t when = base | (static_cast<std::uint64_t>(lowestBit(occupied[level])) << shift);
+         if (!found || when < t)
+             t = when;
+         found = true;
+     }
+ 
+     if (heads[OverflowSlot] != NullHandle)
+     {
+         std::uint64_t when = ((current >> SpanBits) + 1) << SpanBits;
+         if (!found || when < t)
+             t = when;
+         found = true;
+     }
+     return found;
+ }
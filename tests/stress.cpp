@@ -8,39 +8,45 @@
  * Usage:
  *   make stress-run                # Default: 2,000,000 orders
  *   make stress-run ORDERS=5000000 # Custom order count
+ *   make stress-run-dense          # Same flow on the tick-indexed DenseOrderBook
+ *   make stress-run-multi          # Same flow spread over 3,000 symbols in a BookManager
+ *   make stress-run-sharded WORKERS=8  # The 3,000 symbols sharded over pinned worker threads
+ *   make stress-run-gateways GATEWAYS=4 # Gateway threads through the MPSC sequencer vs. a mutex
  * 
  * This test is useful for performance tuning and benchmarking changes to the matching engine.
  * 
  * Author: Nick Ingargiola
  */
 
+ #include "book_manager.h"
+ #include "sequenced_engine.h"
+ #include "sharded_engine.h"
  #include "order_book.h"
  #include "order.h"
+ #include <algorithm>
  #include <chrono>
  #include <iostream>
+ #include <mutex>
  #include <random>
+ #include <string>
+ #include <thread>
+ #include <utility>
+ #include <vector>
  
  /**
-  * @brief Entry point for the stress test.
-  * 
-  * @param argc Command-line arg count
-  * @param argv argv[1] optionally sets number of orders to generate
-  * @return int Exit status code
+  * @brief Submit random orders to @p book and report throughput.
+  *
+  * @param book Book under test (any ladder backend)
+  * @param numOrders Number of orders to generate
   */
- int main(int argc, char** argv) {
-     OrderBook book;
+ template <typename Book>
+ void runStress(Book &book, int numOrders) {
      book.setAutoExport(false); // Disable CSV writes for speed
      book.setExportDir("exports");
  
      long timestamp = 1;  ///< Simulated timestamp
      int nextId = 1;      ///< Incrementing order ID
  
-     // Default to 2M orders unless overridden by command-line
-     int numOrders = 2'000'000;
-     if (argc > 1) {
-         numOrders = std::stoi(argv[1]);
-     }
- 
      // RNG setup for reproducible runs
      std::mt19937 rng(42);
      std::uniform_real_distribution<double> priceDist(90.0, 110.0); // Price range
@@ -52,7 +58,7 @@
      // Generate and submit orders
      for (int i = 0; i < numOrders; i++) {
          OrderType type = sideDist(rng) ? OrderType::BUY : OrderType::SELL;
-         double price = priceDist(rng);
+         Price price = book.toTicks(priceDist(rng));
          int qty = qtyDist(rng);
          book.addOrder(Order(nextId++, type, price, qty, timestamp++));
      }
@@ -61,15 +67,259 @@
      std::chrono::duration<double> elapsed = end - start;
  
      // Throughput calculation
-     double tradesPerSec = book.getTrades().size() / elapsed.count();
+     double tradesPerSec = book.getTradeCount() / elapsed.count();
  
      // Summary report
      std::cout << "STRESS RESULTS:\n";
      std::cout << "Orders processed: " << numOrders << "\n";
-     std::cout << "Trades executed: " << book.getTrades().size() << "\n";
+     std::cout << "Trades executed: " << book.getTradeCount() << "\n";
      std::cout << "Elapsed time: " << elapsed.count() << " sec\n";
      std::cout << "Throughput: " << tradesPerSec << " trades/sec\n";
+ }
+ 
+ /**
+  * @brief Submit random orders across @p numSymbols symbols of a BookManager and report throughput.
+  *
+  * Symbols are interned up front, so each order is routed by SymbolId.
+  *
+  * @param numOrders Number of orders to generate
+  * @param numSymbols Number of instruments
+  */
+ void runMultiStress(int numOrders, int numSymbols) {
+     BookConfig cfg;
+     cfg.directOrderIds = true; // IDs are dense per symbol
+     BookManager engine(cfg);
+     engine.setAutoExport(false);
+ 
+     std::vector<SymbolId> ids;
+     for (int s = 0; s < numSymbols; ++s)
+         ids.push_back(engine.intern("SYM" + std::to_string(s)));
+     std::vector<int> nextIds(numSymbols, 1);
+     long timestamp = 1;
+ 
+     std::mt19937 rng(42);
+     std::uniform_real_distribution<double> priceDist(90.0, 110.0);
+     std::uniform_int_distribution<int> qtyDist(1, 5);
+     std::uniform_int_distribution<int> sideDist(0, 1);
+     std::uniform_int_distribution<int> symbolDist(0, numSymbols - 1);
+ 
+     auto start = std::chrono::high_resolution_clock::now();
+ 
+     for (int i = 0; i < numOrders; i++) {
+         int s = symbolDist(rng);
+         OrderType type = sideDist(rng) ? OrderType::BUY : OrderType::SELL;
+         OrderBook &book = engine.book(ids[s]);
+         book.addOrder(Order(nextIds[s]++, type, book.toTicks(priceDist(rng)), qtyDist(rng), timestamp++));
+     }
+ 
+     auto end = std::chrono::high_resolution_clock::now();
+     std::chrono::duration<double> elapsed = end - start;
+ 
+     std::uint64_t trades = 0;
+     engine.forEachBook([&](SymbolId, OrderBook &book) { trades += book.getTradeCount(); });
+ 
+     std::cout << "STRESS RESULTS:\n";
+     std::cout << "Orders processed: " << numOrders << "\n";
+     std::cout << "Books: " << engine.bookCount() << "\n";
+     std::cout << "Trades executed: " << trades << "\n";
+     std::cout << "Elapsed time: " << elapsed.count() << " sec\n";
+     std::cout << "Throughput: " << trades / elapsed.count() << " trades/sec\n";
+ }
+ 
+ /**
+  * @brief Submit random orders across @p numSymbols symbols of a ShardedEngine and report throughput.
+  *
+  * Orders are generated before the clock starts, so the timed loop measures
+  * routing and matching rather than the random number generator; the clock
+  * stops once every worker has drained its ring.
+  *
+  * @param numOrders Number of orders to generate
+  * @param numSymbols Number of instruments
+  * @param numWorkers Worker threads
+  */
+ void runShardedStress(int numOrders, int numSymbols, std::size_t numWorkers) {
+     ShardConfig shards;
+     shards.workers = numWorkers;
+     BookConfig cfg;
+     cfg.directOrderIds = true; // IDs are dense per symbol
+     ShardedEngine engine(shards, cfg);
+ 
+     std::vector<SymbolId> ids;
+     for (int s = 0; s < numSymbols; ++s)
+         ids.push_back(engine.intern("SYM" + std::to_string(s)));
+     std::vector<int> nextIds(numSymbols, 1);
+ 
+     std::mt19937 rng(42);
+     std::uniform_real_distribution<double> priceDist(90.0, 110.0);
+     std::uniform_int_distribution<int> qtyDist(1, 5);
+     std::uniform_int_distribution<int> sideDist(0, 1);
+     std::uniform_int_distribution<int> symbolDist(0, numSymbols - 1);
+ 
+     std::vector<std::pair<SymbolId, Order>> flow;
+     flow.reserve(numOrders);
+     for (int i = 0; i < numOrders; i++) {
+         int s = symbolDist(rng);
+         OrderType type = sideDist(rng) ? OrderType::BUY : OrderType::SELL;
+         Price price = engine.priceScale().toTicks(priceDist(rng));
+         flow.emplace_back(ids[s], Order(nextIds[s]++, type, price, qtyDist(rng), i + 1));
+     }
+     engine.drain();
+ 
+     auto start = std::chrono::high_resolution_clock::now();
+ 
+     for (const auto &[id, order] : flow)
+         engine.addOrder(id, order);
+     engine.drain();
+ 
+     auto end = std::chrono::high_resolution_clock::now();
+     std::chrono::duration<double> elapsed = end - start;
+ 
+     std::uint64_t trades = 0;
+     std::size_t books = 0;
+     engine.forEachBook([&](SymbolId, OrderBook &book) { trades += book.getTradeCount(); ++books; });
+     std::size_t pinned = 0;
+     for (std::size_t w = 0; w < engine.workerCount(); ++w)
+         pinned += engine.isPinned(w);
+ 
+     std::cout << "STRESS RESULTS:\n";
+     std::cout << "Orders processed: " << numOrders << "\n";
+     std::cout << "Workers: " << engine.workerCount() << " (" << pinned << " pinned)\n";
+     std::cout << "Books: " << books << "\n";
+     std::cout << "Trades executed: " << trades << "\n";
+     std::cout << "Elapsed time: " << elapsed.count() << " sec\n";
+     std::cout << "Throughput: " << trades / elapsed.count() << " trades/sec\n";
+ }
+ 
+ /**
+  * @brief Submit random orders for 64 symbols from @p numGateways threads and report throughput.
+  *
+  * Runs the same flow twice: once through a SequencedEngine, and once with the
+  * gateways serialized by a mutex around a shared BookManager, which is the
+  * arrangement the sequencer replaces. Each gateway generates its orders
+  * before the clock starts.
+  *
+  * @param numOrders Total number of orders (split evenly across gateways)
+  * @param numGateways Submitting threads
+  */
+ void runGatewayStress(int numOrders, int numGateways) {
+     const int numSymbols = 64;
+     const int perGateway = numOrders / numGateways;
+     BookConfig cfg;
+     cfg.directOrderIds = true; // Each gateway owns a dense ID range
+     PriceScale scale(cfg.tickSize);
+ 
+     std::vector<std::vector<std::pair<SymbolId, Order>>> flows(numGateways);
+     for (int g = 0; g < numGateways; ++g) {
+         std::mt19937 rng(42 + g);
+         std::uniform_real_distribution<double> priceDist(90.0, 110.0);
+         std::uniform_int_distribution<int> qtyDist(1, 5);
+         std::uniform_int_distribution<int> sideDist(0, 1);
+         std::uniform_int_distribution<int> symbolDist(0, numSymbols - 1);
+         flows[g].reserve(perGateway);
+         for (int i = 0; i < perGateway; i++) {
+             OrderType type = sideDist(rng) ? OrderType::BUY : OrderType::SELL;
+             SymbolId symbol = symbolDist(rng);
+             Price price = scale.toTicks(priceDist(rng));
+             flows[g].emplace_back(symbol, Order(g * perGateway + i + 1, type, price, qtyDist(rng), 0));
+         }
+     }
+ 
+     auto report = [&](const char *label, double seconds, std::uint64_t trades) {
+         std::cout << label << ": " << numGateways * perGateway << " orders, " << trades << " trades in "
+                   << seconds << " sec (" << numGateways * perGateway / seconds << " orders/sec)\n";
+     };
+ 
+     {
+         SequencedEngine engine(SequencerConfig{}, cfg);
+         for (int s = 0; s < numSymbols; ++s)
+             engine.intern("SYM" + std::to_string(s));
+         engine.drain();
+ 
+         auto start = std::chrono::high_resolution_clock::now();
+         std::vector<std::thread> gateways;
+         for (int g = 0; g < numGateways; ++g)
+             gateways.emplace_back([&engine, &flow = flows[g]] {
+                 for (const auto &[symbol, order] : flow)
+                     engine.addOrder(symbol, order);
+             });
+         for (auto &t : gateways)
+             t.join();
+         engine.drain();
+         std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+ 
+         std::uint64_t trades = 0;
+         engine.forEachBook([&](SymbolId, OrderBook &book) { trades += book.getTradeCount(); });
+         report("Sequencer", elapsed.count(), trades);
+     }
+ 
+     {
+         BookManager engine(cfg);
+         engine.setAutoExport(false);
+         for (int s = 0; s < numSymbols; ++s)
+             engine.intern("SYM" + std::to_string(s));
+         std::mutex lock;
+         long timestamp = 1;
+ 
+         auto start = std::chrono::high_resolution_clock::now();
+         std::vector<std::thread> gateways;
+         for (int g = 0; g < numGateways; ++g)
+             gateways.emplace_back([&, &flow = flows[g]] {
+                 for (auto [symbol, order] : flow) {
+                     std::lock_guard<std::mutex> guard(lock);
+                     order.timestamp = timestamp++;
+                     engine.addOrder(symbol, order);
+                 }
+             });
+         for (auto &t : gateways)
+             t.join();
+         std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+ 
+         std::uint64_t trades = 0;
+         engine.forEachBook([&](SymbolId, OrderBook &book) { trades += book.getTradeCount(); });
+         report("Mutex", elapsed.count(), trades);
+     }
+ }
+ 
+ /**
+  * @brief Entry point for the stress test.
+  * 
+  * @param argc Command-line arg count
+  * @param argv argv[1] optionally sets number of orders to generate,
+  *             argv[2] == "dense" selects the DenseOrderBook backend,
+  *             argv[2] == "multi" spreads orders over 3,000 symbols,
+  *             argv[2] == "sharded" spreads them over argv[3] worker threads (default: one per core),
+  *             argv[2] == "gateways" submits from argv[3] threads (default 4) via the sequencer and a mutex
+  * @return int Exit status code
+  */
+ int main(int argc, char** argv) {
+     // Default to 2M orders unless overridden by command-line
+     int numOrders = 2'000'000;
+     if (argc > 1) {
+         numOrders = std::stoi(argv[1]);
+     }
+ 
+     if (argc > 2 && std::string(argv[2]) == "gateways") {
+         runGatewayStress(numOrders, argc > 3 ? std::max(1, std::stoi(argv[3])) : 4);
+     } else if (argc > 2 && std::string(argv[2]) == "sharded") {
+         std::size_t workers = argc > 3 ? std::stoul(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+         runShardedStress(numOrders, 3000, workers);
+     } else if (argc > 2 && std::string(argv[2]) == "multi") {
+         runMultiStress(numOrders, 3000);
+     } else if (argc > 2 && std::string(argv[2]) == "dense") {
+         // Band covers the generator's 90-110 price range
+         BookConfig cfg;
+         cfg.directOrderIds = true;
+         cfg.tickSize = 0.01;
+         cfg.minPrice = 90.0;
+         cfg.maxPrice = 110.0;
+         DenseOrderBook book(cfg);
+         runStress(book, numOrders);
+     } else {
+         BookConfig cfg;
+         cfg.directOrderIds = true; // IDs come from nextId, so they are dense
+         OrderBook book(cfg);
+         runStress(book, numOrders);
+     }
  
      return 0;
  }
- 
\ No newline at end of file
@@ -11,12 +11,37 @@
  *  - Performance benchmarking
  *  - Integration with live feed
  *  - Bulk cancelation scenarios
+ *  - Dense (tick-indexed) ladder backend and its occupancy bitmap
+ *  - Symbol sharding across worker threads and its SPSC rings
+ *  - Multi-gateway submission through the MPSC sequencer
+ *  - Staged CLI pipeline and its shared stage ring
+ *  - Seqlock-published top of book read from another thread
  */
 
  #include <gtest/gtest.h>
  #include "order_book.h"
+ #include "tick_bitmap.h"
+ #include "order_pool.h"
+ #include "order_id_map.h"
+ #include "order_index.h"
+ #include "timer_wheel.h"
+ #include "book_manager.h"
+ #include "sharded_engine.h"
+ #include "spsc_ring.h"
+ #include "mpsc_sequencer.h"
+ #include "sequenced_engine.h"
+ #include "stage_ring.h"
+ #include "cli_pipeline.h"
+ #include "top_of_book.h"
+ #include <unordered_map>
+ #include <algorithm>
+ #include <climits>
+ #include <map>
  #include <random>
  #include <sstream>
+ #include <fstream>
+ #include <cstdio>
+ #include <thread>
  
  /**
   * @brief Test fixture providing a fresh OrderBook for each test.
@@ -34,13 +59,14 @@
      /**
       * @brief Helper to insert a new order into the book.
       * @param t   Order side (BUY/SELL)
-      * @param px  Price
+      * @param px  Decimal price (converted to ticks)
       * @param qty Quantity
+      * @param kind Order kind (LIMIT by default)
       * @return The assigned order ID
       */
-     int add(OrderType t, double px, int qty) {
+     int add(OrderType t, double px, int qty, OrderKind kind = OrderKind::LIMIT) {
          int id = nextId++;
-         book.addOrder(Order(id, t, px, qty, ts++));
+         book.addOrder(Order(id, t, book.toTicks(px), qty, ts++, kind));
          return id;
      }
  };
@@ -56,7 +82,7 @@
      ASSERT_EQ(tr.size(), 1u);
      EXPECT_EQ(tr[0].buyId, b1);
      EXPECT_EQ(tr[0].sellId, s1);
-     EXPECT_DOUBLE_EQ(tr[0].price, 99.0);
+     EXPECT_DOUBLE_EQ(book.toPrice(tr[0].price), 99.0);
      EXPECT_EQ(tr[0].quantity, 5);
  }
  
@@ -93,6 +119,306 @@
      EXPECT_TRUE(book.getTrades().empty());
  }
  
+ /** @test Aggressive orders sweep levels best price first, regardless of arrival order. */
+ TEST_F(OBFixture, SweepsLevelsInPriceOrder) {
+     int b100 = add(OrderType::BUY, 100.0, 2);
+     int b102 = add(OrderType::BUY, 102.0, 2);
+     int b99  = add(OrderType::BUY, 99.0, 2);
+     int b101 = add(OrderType::BUY, 101.0, 2);
+     add(OrderType::SELL, 99.0, 7);
+ 
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 4u);
+     EXPECT_EQ(tr[0].buyId, b102);
+     EXPECT_EQ(tr[1].buyId, b101);
+     EXPECT_EQ(tr[2].buyId, b100);
+     EXPECT_EQ(tr[3].buyId, b99);
+     EXPECT_EQ(tr[3].quantity, 1);
+     EXPECT_TRUE(book.cancelOrder(b99)); // Partially filled remainder still rests
+ }
+ 
+ /** @test A marketable order that fills completely never rests; its residual rests at its limit. */
+ TEST_F(OBFixture, MarketableOrderMatchesBeforeResting) {
+     add(OrderType::SELL, 100.0, 3);
+     add(OrderType::SELL, 101.0, 3);
+     int b1 = add(OrderType::BUY, 100.0, 3);
+     EXPECT_FALSE(book.cancelOrder(b1)); // Filled on entry, never indexed
+     EXPECT_FALSE(book.bestBid().has_value());
+ 
+     int b2 = add(OrderType::BUY, 101.0, 5);
+     ASSERT_EQ(book.getTrades().size(), 2u);
+     EXPECT_EQ(book.getTrades()[1].price, book.toTicks(101.0));
+     EXPECT_EQ(book.bestBid(), book.toTicks(101.0));
+     EXPECT_EQ(book.bestBidQty(), 2);
+     EXPECT_FALSE(book.bestAsk().has_value());
+     EXPECT_TRUE(book.cancelOrder(b2));
+ }
+ 
+ /** @test IOC trades what crosses and discards the rest; it never rests or gets indexed. */
+ TEST_F(OBFixture, IocDiscardsResidual) {
+     add(OrderType::SELL, 100.0, 3);
+     add(OrderType::SELL, 102.0, 3);
+     int b1 = add(OrderType::BUY, 101.0, 5, OrderKind::IOC);
+ 
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 1u);
+     EXPECT_EQ(tr[0].quantity, 3);
+     EXPECT_FALSE(book.bestBid().has_value());
+     EXPECT_FALSE(book.cancelOrder(b1));
+     EXPECT_EQ(book.bestAsk(), book.toTicks(102.0));
+ }
+ 
+ /** @test FOK executes only when the crossing levels hold its full quantity. */
+ TEST_F(OBFixture, FillOrKillAllOrNothing) {
+     add(OrderType::BUY, 100.0, 2);
+     add(OrderType::BUY, 99.0, 2);
+     add(OrderType::BUY, 98.0, 5);
+ 
+     add(OrderType::SELL, 99.0, 5, OrderKind::FOK); // Only 4 at or above 99
+     EXPECT_TRUE(book.getTrades().empty());
+     EXPECT_EQ(book.bestBidQty(), 2);
+ 
+     add(OrderType::SELL, 99.0, 4, OrderKind::FOK);
+     EXPECT_EQ(book.getTrades().size(), 2u);
+     EXPECT_EQ(book.bestBid(), book.toTicks(98.0));
+     EXPECT_FALSE(book.bestAsk().has_value());
+ }
+ 
+ /** @test Market orders sweep at the resting prices regardless of their own price field. */
+ TEST_F(OBFixture, MarketOrdersSweepAtRestingPrices) {
+     add(OrderType::BUY, 100.0, 2);
+     add(OrderType::BUY, 97.0, 2);
+     add(OrderType::SELL, 0.0, 3, OrderKind::MARKET);
+ 
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 2u);
+     EXPECT_EQ(tr[0].price, book.toTicks(100.0));
+     EXPECT_EQ(tr[1].price, book.toTicks(97.0));
+     EXPECT_EQ(book.bestBidQty(), 1);
+ 
+     add(OrderType::SELL, 103.0, 1);
+     add(OrderType::BUY, 0.0, 5, OrderKind::MARKET);
+     ASSERT_EQ(tr.size(), 3u);
+     EXPECT_EQ(tr[2].price, book.toTicks(103.0));
+     EXPECT_EQ(book.bestBid(), book.toTicks(97.0)); // Residual was discarded, not rested
+     EXPECT_FALSE(book.bestAsk().has_value());
+ }
+ 
+ /** @test Auction mode accumulates a crossed book and uncrosses at the max-volume price. */
+ TEST_F(OBFixture, AuctionUncrossesAtMaxVolumePrice) {
+     book.setAuctionMode(true);
+     add(OrderType::BUY, 102.0, 5);
+     add(OrderType::BUY, 101.0, 5);
+     add(OrderType::BUY, 100.0, 5);
+     add(OrderType::SELL, 99.0, 4);
+     add(OrderType::SELL, 100.0, 4);
+     add(OrderType::SELL, 101.0, 4);
+     add(OrderType::SELL, 103.0, 10);
+     add(OrderType::SELL, 99.0, 1, OrderKind::IOC); // Rejected during the auction
+     EXPECT_TRUE(book.getTrades().empty());
+     EXPECT_EQ(book.indicativePrice(), book.toTicks(101.0));
+ 
+     // Executable volume by price: 99 -> 4, 100 -> 8, 101 -> 10, 102 -> 5
+     EXPECT_EQ(book.uncross(), book.toTicks(101.0));
+     std::int64_t filled = 0;
+     for (const Trade &t : book.getTrades()) {
+         EXPECT_EQ(t.price, book.toTicks(101.0));
+         filled += t.quantity;
+     }
+     EXPECT_EQ(filled, 10);
+     EXPECT_EQ(book.bestBid(), book.toTicks(100.0));
+     EXPECT_EQ(book.bestBidQty(), 5);
+     EXPECT_EQ(book.bestAsk(), book.toTicks(101.0));
+     EXPECT_EQ(book.bestAskQty(), 2);
+     EXPECT_FALSE(book.uncross().has_value());
+ 
+     book.setAuctionMode(false);
+     add(OrderType::BUY, 101.0, 2); // Continuous matching again
+     EXPECT_EQ(book.bestAskQty(), 10);
+ }
+ 
+ /** @test Stops rest outside the book and release, by trigger, when trades reach them. */
+ TEST_F(OBFixture, StopOrdersElectOnLastTrade) {
+     auto stop = [&](OrderType t, double trigger, double limit, int qty, OrderKind kind) {
+         Order o(nextId++, t, book.toTicks(limit), qty, ts++, kind);
+         o.stopPrice = book.toTicks(trigger);
+         book.addOrder(o);
+         return o.id;
+     };
+     add(OrderType::SELL, 101.0, 2);
+     add(OrderType::SELL, 102.0, 2);
+     add(OrderType::SELL, 103.0, 5);
+     int a = stop(OrderType::BUY, 102.0, 0.0, 2, OrderKind::STOP);
+     int b = stop(OrderType::BUY, 101.0, 101.5, 3, OrderKind::STOP_LIMIT);
+     int c = stop(OrderType::SELL, 95.0, 0.0, 1, OrderKind::STOP);
+     EXPECT_TRUE(book.getTrades().empty());
+     EXPECT_FALSE(book.bestBid().has_value()); // Stops are not visible depth
+ 
+     add(OrderType::BUY, 101.0, 2); // Prints 101: elects b only, which rests at 101.5
+     EXPECT_EQ(book.getTrades().size(), 1u);
+     EXPECT_EQ(book.bestBid(), book.toTicks(101.5));
+     EXPECT_EQ(book.bestBidQty(), 3);
+ 
+     add(OrderType::BUY, 102.0, 1); // Prints 102: elects a, a market buy for 2
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 4u);
+     EXPECT_EQ(tr[2].buyId, a);
+     EXPECT_EQ(tr[2].price, book.toTicks(102.0));
+     EXPECT_EQ(tr[3].buyId, a);
+     EXPECT_EQ(tr[3].price, book.toTicks(103.0));
+     EXPECT_EQ(book.lastTradePrice(), book.toTicks(103.0));
+     EXPECT_EQ(book.bestAskQty(), 4);
+ 
+     EXPECT_FALSE(book.cancelOrder(a));
+     EXPECT_TRUE(book.cancelOrder(b));
+     EXPECT_TRUE(book.cancelOrder(c)); // Still pending, cancelable by ID
+ }
+ 
+ /** @test Stop releases cascade in deterministic order; an already-reached trigger fires on entry. */
+ TEST_F(OBFixture, StopCascadeIsDeterministic) {
+     auto sellStop = [&](double trigger, int qty) {
+         Order o(nextId++, OrderType::SELL, 0, qty, ts++, OrderKind::STOP);
+         o.stopPrice = book.toTicks(trigger);
+         book.addOrder(o);
+         return o.id;
+     };
+     add(OrderType::BUY, 99.0, 1);
+     add(OrderType::BUY, 98.0, 1);
+     add(OrderType::BUY, 97.0, 5);
+     int s1 = sellStop(99.0, 1);
+     int s2 = sellStop(98.0, 1);
+ 
+     add(OrderType::SELL, 99.0, 1);
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 3u);
+     EXPECT_EQ(tr[1].sellId, s1);
+     EXPECT_EQ(tr[1].price, book.toTicks(98.0));
+     EXPECT_EQ(tr[2].sellId, s2);
+     EXPECT_EQ(tr[2].price, book.toTicks(97.0));
+ 
+     int s3 = sellStop(100.0, 2); // Last trade 97 is already through 100
+     ASSERT_EQ(tr.size(), 4u);
+     EXPECT_EQ(tr[3].sellId, s3);
+     EXPECT_EQ(book.bestBidQty(), 2);
+ }
+ 
+ /** @test Pro-rata splits an incoming order by resting size, with the rounding remainder going FIFO. */
+ TEST(ProRataOrderBook, AllocatesBySizeThenFifo) {
+     ProRataOrderBook book;
+     book.setAutoExport(false);
+     book.addOrder(Order(1, OrderType::SELL, 10000, 10, 1));
+     book.addOrder(Order(2, OrderType::SELL, 10000, 30, 2));
+     book.addOrder(Order(3, OrderType::SELL, 10000, 60, 3));
+     book.addOrder(Order(4, OrderType::BUY, 10000, 11, 4));
+ 
+     std::map<int, int> filled;
+     for (const auto &t : book.getTrades())
+         filled[t.sellId] += t.quantity;
+     EXPECT_EQ(filled[1], 2);  // floor(1.1) + the leftover lot
+     EXPECT_EQ(filled[2], 3);
+     EXPECT_EQ(filled[3], 6);
+     EXPECT_EQ(book.bestAskQty(), 89);
+ }
+ 
+ /** @test The order that opened a level fills first; the rest is shared pro-rata. */
+ TEST(ProRataOrderBook, TopOrderFillsFirst) {
+     BasicOrderBook<MapLadder, TopOrderPolicy<ProRataPolicy>> book;
+     book.setAutoExport(false);
+     book.addOrder(Order(1, OrderType::SELL, 10000, 10, 1));
+     book.addOrder(Order(2, OrderType::SELL, 10000, 30, 2));
+     book.addOrder(Order(3, OrderType::SELL, 10000, 60, 3));
+     book.addOrder(Order(4, OrderType::BUY, 10000, 50, 4));
+ 
+     std::map<int, int> filled;
+     for (const auto &t : book.getTrades())
+         filled[t.sellId] += t.quantity;
+     EXPECT_EQ(filled[1], 10);
+     EXPECT_EQ(filled[2], 14);  // 13 pro-rata + the leftover lot
+     EXPECT_EQ(filled[3], 26);
+ 
+     // The top order is gone, so the level has none and the next fill is pure pro-rata
+     book.addOrder(Order(5, OrderType::BUY, 10000, 9, 5));
+     filled.clear();
+     for (const auto &t : book.getTrades())
+         if (t.buyId == 5)
+             filled[t.sellId] += t.quantity;
+     EXPECT_EQ(filled[2], 3);
+     EXPECT_EQ(filled[3], 6);
+ }
+ 
+ /** @test Iceberg slices refill from reserve and requeue behind the level without a new order. */
+ TEST_F(OBFixture, IcebergRefillsAndRequeues) {
+     Order ice(nextId++, OrderType::SELL, book.toTicks(100.0), 10, ts++);
+     ice.displayQty = 4;
+     book.addOrder(ice);
+     int s2 = add(OrderType::SELL, 100.0, 3);
+ 
+     auto lvl = book.getLevel(OrderType::SELL, book.toTicks(100.0));
+     ASSERT_TRUE(lvl.has_value());
+     EXPECT_EQ(lvl->quantity, 7); // 4 displayed + 3
+     EXPECT_EQ(lvl->total, 13);
+     EXPECT_EQ(lvl->orders, 2u);
+ 
+     add(OrderType::BUY, 100.0, 6); // Slice of 4, then s2 is ahead of the refill
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 2u);
+     EXPECT_EQ(tr[0].sellId, ice.id);
+     EXPECT_EQ(tr[0].quantity, 4);
+     EXPECT_EQ(tr[1].sellId, s2);
+     EXPECT_EQ(tr[1].quantity, 2);
+ 
+     lvl = book.getLevel(OrderType::SELL, book.toTicks(100.0));
+     EXPECT_EQ(lvl->quantity, 5); // s2's 1 + refilled slice of 4
+     EXPECT_EQ(lvl->total, 7);
+ 
+     add(OrderType::BUY, 100.0, 7, OrderKind::IOC); // Hidden reserve is executable
+     EXPECT_FALSE(book.bestAsk().has_value());
+     EXPECT_FALSE(book.cancelOrder(ice.id));
+ }
+ 
+ /** @test A callback sink sees adds, in-place modifies, trades and cancels as they happen. */
+ TEST(EventSink, CallbackSinkReceivesLifecycle) {
+     BasicOrderBook<MapLadder, FifoPolicy, CallbackSink> book;
+     book.setAutoExport(false);
+     std::vector<std::string> events;
+     CallbackSink &sink = book.eventSink();
+     sink.trade = [&](const Trade &t) { events.push_back("T" + std::to_string(t.buyId) + "/" + std::to_string(t.sellId) + "x" + std::to_string(t.quantity)); };
+     sink.add = [&](const Order &o) { events.push_back("A" + std::to_string(o.id)); };
+     sink.cancel = [&](const Order &o) { events.push_back("C" + std::to_string(o.id)); };
+     sink.modify = [&](const Order &o) { events.push_back("M" + std::to_string(o.id) + "=" + std::to_string(o.quantity)); };
+ 
+     book.addOrder(Order(1, OrderType::SELL, 10100, 10, 1));
+     book.addOrder(Order(2, OrderType::SELL, 10200, 5, 2));
+     book.modifyOrder(1, 8, 10100, 3);           // in place
+     book.addOrder(Order(3, OrderType::BUY, 10100, 3, 4));
+     book.modifyOrder(2, 5, 10300, 5);           // loses priority: cancel + re-entry
+     book.cancelOrder(1);
+ 
+     // A pending stop is silent whether it is cut in place or canceled
+     Order stop(4, OrderType::BUY, 10400, 6, 6, OrderKind::STOP_LIMIT);
+     stop.stopPrice = 10400;
+     book.addOrder(stop);
+     EXPECT_TRUE(book.modifyOrder(4, 2, 10400, 7));
+     EXPECT_TRUE(book.cancelOrder(4));
+ 
+     std::vector<std::string> expected = {"A1", "A2", "M1=8", "T3/1x3", "C2", "A2", "C1"};
+     EXPECT_EQ(events, expected);
+     EXPECT_EQ(book.getTradeCount(), 1u);
+ }
+ 
+ /** @test A null sink keeps nothing, while the book still counts trades. */
+ TEST(EventSink, NullSinkCountsTrades) {
+     BasicOrderBook<MapLadder, FifoPolicy, NullSink> book;
+     book.setAutoExport(false);
+     book.addOrder(Order(1, OrderType::SELL, 10000, 5, 1));
+     book.addOrder(Order(2, OrderType::SELL, 10000, 5, 2));
+     book.addOrder(Order(3, OrderType::BUY, 10000, 7, 3));
+     EXPECT_EQ(book.getTradeCount(), 2u);
+     EXPECT_EQ(book.bestAskQty(), 3);
+     static_assert(!HasTradeHistory<NullSink>::value, "NullSink keeps no history");
+     static_assert(HasTradeHistory<TradeLog>::value, "TradeLog keeps history");
+ }
+ 
  // ------------------ CANCEL / MODIFY TESTS ------------------
  
  /** @test Cancelation works and handles non-existent IDs gracefully. */
@@ -104,40 +430,225 @@
      EXPECT_TRUE(book.cancelOrder(b1));
  }
  
+ /** @test Canceling from the middle of a level keeps FIFO order of the remaining orders. */
+ TEST_F(OBFixture, CancelMiddleKeepsFifo) {
+     int s1 = add(OrderType::SELL, 100.0, 1);
+     int s2 = add(OrderType::SELL, 100.0, 1);
+     int s3 = add(OrderType::SELL, 100.0, 1);
+     EXPECT_TRUE(book.cancelOrder(s2));
+     add(OrderType::BUY, 100.0, 2);
+ 
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 2u);
+     EXPECT_EQ(tr[0].sellId, s1);
+     EXPECT_EQ(tr[1].sellId, s3);
+ }
+ 
  /** @test Modify changes both price and quantity, potentially triggering a trade. */
  TEST_F(OBFixture, ModifyChangesPriceAndQty) {
      int s1 = add(OrderType::SELL, 101.0, 10);
      int b1 = add(OrderType::BUY, 100.0, 6);
-     EXPECT_TRUE(book.modifyOrder(s1, 8, 100.0, ts++)); // Now crosses
+     EXPECT_TRUE(book.modifyOrder(s1, 8, book.toTicks(100.0), ts++)); // Now crosses
  
      const auto &tr = book.getTrades();
      ASSERT_FALSE(tr.empty());
-     EXPECT_EQ(tr.back().price, 100.0);
+     EXPECT_DOUBLE_EQ(book.toPrice(tr.back().price), 100.0);
      EXPECT_EQ(tr.back().quantity, 6);
  }
  
+ /** @test Reducing size at the same price keeps time priority; increasing size loses it. */
+ TEST_F(OBFixture, ModifySizeDownKeepsPriority) {
+     int s1 = add(OrderType::SELL, 100.0, 10);
+     int s2 = add(OrderType::SELL, 100.0, 5);
+     EXPECT_TRUE(book.modifyOrder(s1, 4, book.toTicks(100.0), ts++));
+     EXPECT_TRUE(book.getTrades().empty());
+     EXPECT_EQ(book.bestAskQty(), 9);
+ 
+     add(OrderType::BUY, 100.0, 4);
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 1u);
+     EXPECT_EQ(tr[0].sellId, s1); // Still first in the queue
+ 
+     int s3 = add(OrderType::SELL, 100.0, 2);
+     EXPECT_TRUE(book.modifyOrder(s2, 6, book.toTicks(100.0), ts++)); // Size up -> back of queue
+     add(OrderType::BUY, 100.0, 2);
+     ASSERT_EQ(tr.size(), 2u);
+     EXPECT_EQ(tr[1].sellId, s3);
+ }
+ 
+ /** @test Modifying an iceberg down sheds reserve first and keeps priority. */
+ TEST_F(OBFixture, IcebergModifyShedsReserveFirst) {
+     Order ice(nextId++, OrderType::BUY, book.toTicks(100.0), 12, ts++);
+     ice.displayQty = 5;
+     book.addOrder(ice);
+     EXPECT_TRUE(book.modifyOrder(ice.id, 8, book.toTicks(100.0), ts++));
+     auto lvl = book.getLevel(OrderType::BUY, book.toTicks(100.0));
+     EXPECT_EQ(lvl->quantity, 5);
+     EXPECT_EQ(lvl->total, 8);
+     EXPECT_TRUE(book.modifyOrder(ice.id, 2, book.toTicks(100.0), ts++));
+     lvl = book.getLevel(OrderType::BUY, book.toTicks(100.0));
+     EXPECT_EQ(lvl->quantity, 2);
+     EXPECT_EQ(lvl->total, 2);
+     EXPECT_TRUE(book.cancelOrder(ice.id));
+     EXPECT_FALSE(book.bestBid().has_value());
+ }
+ 
+ /** @test Good-till-time orders leave the book and index when the clock reaches them. */
+ TEST_F(OBFixture, GoodTillTimeOrdersExpire) {
+     auto gtt = [&](OrderType t, double px, int qty, long expireAt) {
+         Order o(nextId++, t, book.toTicks(px), qty, ts++);
+         o.expireAt = expireAt;
+         book.addOrder(o);
+         return o.id;
+     };
+     int b1 = gtt(OrderType::BUY, 100.0, 5, 1000);
+     int b2 = gtt(OrderType::BUY, 100.0, 3, 5000);
+     int s1 = gtt(OrderType::SELL, 101.0, 4, 1000);
+     int b3 = add(OrderType::BUY, 99.0, 1); // Good till canceled
+     add(OrderType::SELL, 100.0, 3);         // Fills b1 partially; its timer stays
+ 
+     EXPECT_EQ(book.advanceTime(999), 0u);
+     EXPECT_EQ(book.advanceTime(1000), 2u); // b1 and s1
+     EXPECT_FALSE(book.cancelOrder(b1));
+     EXPECT_FALSE(book.cancelOrder(s1));
+     EXPECT_FALSE(book.bestAsk().has_value());
+     EXPECT_EQ(book.bestBidQty(), 3);
+ 
+     EXPECT_TRUE(book.cancelOrder(b2)); // Cancel unschedules it
+     EXPECT_EQ(book.advanceTime(1L << 30), 0u);
+     EXPECT_TRUE(book.cancelOrder(b3));
+ 
+     gtt(OrderType::BUY, 100.0, 1, 500); // Already in the past: rejected
+     EXPECT_FALSE(book.bestBid().has_value());
+ }
+ 
+ /** @test A clock that goes backwards, or negative, expires nothing and leaves the book's time alone. */
+ TEST_F(OBFixture, AdvanceTimeIgnoresEarlierTimes) {
+     Order o(nextId++, OrderType::BUY, book.toTicks(100.0), 5, ts++);
+     o.expireAt = 1000;
+     book.addOrder(o);
+ 
+     EXPECT_EQ(book.advanceTime(-1), 0u);
+     EXPECT_EQ(book.currentTime(), 0);
+     EXPECT_EQ(book.advanceTime(500), 0u);
+     EXPECT_EQ(book.advanceTime(100), 0u);
+     EXPECT_EQ(book.currentTime(), 500);
+     EXPECT_EQ(book.bestBidQty(), 5);
+ 
+     BookManager engine;
+     engine.setAutoExport(false);
+     SymbolId sym = engine.intern("X");
+     engine.addOrder(sym, o);
+     EXPECT_EQ(engine.advanceTime(-1), 0u);
+     EXPECT_EQ(engine.book(sym).bestBidQty(), 5);
+     EXPECT_EQ(book.advanceTime(1000), 1u);
+ }
+ 
  /** @test Handles very large order IDs without overflow issues. */
  TEST_F(OBFixture, LargeOrderId) {
      int bigId = 1'000'000'000;
-     book.addOrder(Order(bigId, OrderType::BUY, 105.0, 5, 1));
+     book.addOrder(Order(bigId, OrderType::BUY, book.toTicks(105.0), 5, 1));
      ASSERT_EQ(book.getTrades().size(), 0);
      ASSERT_TRUE(book.cancelOrder(bigId));
  }
  
  /** @test Orders with zero quantity are ignored and never matched. */
  TEST_F(OBFixture, ZeroQuantityIgnored) {
-     book.addOrder(Order(1, OrderType::BUY, 100.0, 0, 1));
-     book.addOrder(Order(2, OrderType::SELL, 99.0, 5, 2));
+     book.addOrder(Order(1, OrderType::BUY, book.toTicks(100.0), 0, 1));
+     book.addOrder(Order(2, OrderType::SELL, book.toTicks(99.0), 5, 2));
      ASSERT_EQ(book.getTrades().size(), 0);
  }
  
- /** @test High-precision floating point prices are accepted. */
+ /** @test High-precision decimal prices are accepted and rounded to the tick grid. */
  TEST_F(OBFixture, HighPrecisionPrice) {
      double price = 100.123456789;
-     book.addOrder(Order(1, OrderType::BUY, price, 5, 1));
+     book.addOrder(Order(1, OrderType::BUY, book.toTicks(price), 5, 1));
      ASSERT_EQ(book.getTrades().size(), 0);
  }
  
+ /** @test Prices that round to the same tick are the same level, so they cross exactly. */
+ TEST_F(OBFixture, TickRoundedPricesCross) {
+     int s1 = add(OrderType::SELL, 0.1 + 0.2, 5); // 0.30000000000000004 as a double
+     int b1 = add(OrderType::BUY, 0.3, 5);
+ 
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 1u);
+     EXPECT_EQ(tr[0].sellId, s1);
+     EXPECT_EQ(tr[0].buyId, b1);
+     EXPECT_EQ(tr[0].price, 30);
+     EXPECT_DOUBLE_EQ(book.toPrice(tr[0].price), 0.3);
+ }
+ 
+ // ------------------ DEPTH / AGGREGATE TESTS ------------------
+ 
+ /** @test Level aggregates track adds, partial fills and cancels. */
+ TEST_F(OBFixture, LevelAggregatesTrackAddFillCancel) {
+     add(OrderType::SELL, 101.0, 4);
+     int s2 = add(OrderType::SELL, 101.0, 6);
+     add(OrderType::SELL, 102.0, 3);
+ 
+     auto lvl = book.getLevel(OrderType::SELL, book.toTicks(101.0));
+     ASSERT_TRUE(lvl.has_value());
+     EXPECT_EQ(lvl->quantity, 10);
+     EXPECT_EQ(lvl->orders, 2u);
+ 
+     add(OrderType::BUY, 101.0, 5); // Fills s1 (4) and 1 of s2
+     lvl = book.getLevel(OrderType::SELL, book.toTicks(101.0));
+     ASSERT_TRUE(lvl.has_value());
+     EXPECT_EQ(lvl->quantity, 5);
+     EXPECT_EQ(lvl->orders, 1u);
+ 
+     EXPECT_TRUE(book.cancelOrder(s2));
+     EXPECT_FALSE(book.getLevel(OrderType::SELL, book.toTicks(101.0)).has_value());
+     EXPECT_FALSE(book.getLevel(OrderType::BUY, book.toTicks(101.0)).has_value());
+ }
+ 
+ /** @test forEachLevel visits at most n levels, best first. */
+ TEST_F(OBFixture, ForEachLevelBestFirst) {
+     add(OrderType::BUY, 99.0, 1);
+     add(OrderType::BUY, 100.0, 2);
+     add(OrderType::BUY, 100.0, 3);
+     add(OrderType::BUY, 98.0, 4);
+ 
+     std::vector<LevelInfo> seen;
+     book.forEachLevel(OrderType::BUY, 2, [&](const LevelInfo &l) { seen.push_back(l); });
+     ASSERT_EQ(seen.size(), 2u);
+     EXPECT_EQ(seen[0].price, book.toTicks(100.0));
+     EXPECT_EQ(seen[0].quantity, 5);
+     EXPECT_EQ(seen[0].orders, 2u);
+     EXPECT_EQ(seen[1].price, book.toTicks(99.0));
+ 
+     int asks = 0;
+     book.forEachLevel(OrderType::SELL, 10, [&](const LevelInfo &) { ++asks; });
+     EXPECT_EQ(asks, 0);
+ }
+ 
+ /** @test Top-of-book accessors follow adds, fills and cancels. */
+ TEST_F(OBFixture, TopOfBookAccessors) {
+     EXPECT_FALSE(book.bestBid().has_value());
+     EXPECT_FALSE(book.spread().has_value());
+     EXPECT_FALSE(book.mid().has_value());
+     EXPECT_EQ(book.bestAskQty(), 0);
+ 
+     add(OrderType::BUY, 99.0, 3);
+     int b2 = add(OrderType::BUY, 100.0, 2);
+     add(OrderType::SELL, 101.0, 7);
+     EXPECT_EQ(book.bestBid(), book.toTicks(100.0));
+     EXPECT_EQ(book.bestAsk(), book.toTicks(101.0));
+     EXPECT_EQ(book.bestBidQty(), 2);
+     EXPECT_EQ(book.bestAskQty(), 7);
+     EXPECT_EQ(book.spread(), book.toTicks(1.0));
+     EXPECT_DOUBLE_EQ(*book.mid(), book.toTicks(100.5));
+ 
+     EXPECT_TRUE(book.cancelOrder(b2));
+     EXPECT_EQ(book.bestBid(), book.toTicks(99.0));
+ 
+     add(OrderType::SELL, 99.0, 3); // Takes out the whole bid side
+     EXPECT_FALSE(book.bestBid().has_value());
+     EXPECT_EQ(book.bestBidQty(), 0);
+     EXPECT_EQ(book.bestAsk(), book.toTicks(101.0));
+ }
+ 
  // ------------------ PERFORMANCE / INTEGRATION ------------------
  
  /**
@@ -156,7 +667,7 @@
      auto start = std::chrono::high_resolution_clock::now();
      for (int i = 0; i < numOrders; i++) {
          OrderType type = sideDist(rng) ? OrderType::BUY : OrderType::SELL;
-         book.addOrder(Order(nextId++, type, priceDist(rng), qtyDist(rng), ts++));
+         book.addOrder(Order(nextId++, type, book.toTicks(priceDist(rng)), qtyDist(rng), ts++));
      }
      auto end = std::chrono::high_resolution_clock::now();
  
@@ -183,7 +694,7 @@
              double price; int qty;
              if (iss >> sideStr >> price >> qty) {
                  OrderType type = (sideStr == "BUY") ? OrderType::BUY : OrderType::SELL;
-                 book.addOrder(Order(nextId++, type, price, qty, ts++));
+                 book.addOrder(Order(nextId++, type, book.toTicks(price), qty, ts++));
              }
          }
      }
@@ -215,4 +726,946 @@
      EXPECT_TRUE(id > 0);
      EXPECT_EQ(book.getTrades().size(), 0);
  }
- 
\ No newline at end of file
+ 
+ /** @test Range and side cancels drop whole levels and clear the index and expiry entries. */
+ TEST_F(OBFixture, CancelRangeAndSideDropWholeLevels) {
+     for (double px : {99.0, 100.0, 101.0}) {
+         add(OrderType::BUY, px, 5);
+         add(OrderType::BUY, px, 5);
+     }
+     Order gtt(nextId++, OrderType::BUY, book.toTicks(100.0), 5, ts++);
+     gtt.expireAt = 50;
+     book.addOrder(gtt);
+     add(OrderType::SELL, 102.0, 5);
+     add(OrderType::SELL, 103.0, 5);
+ 
+     EXPECT_EQ(book.cancelRange(OrderType::BUY, book.toTicks(99.5), book.toTicks(101.0)), 5u);
+     EXPECT_EQ(book.bestBid(), book.toTicks(99.0));
+     EXPECT_FALSE(book.getLevel(OrderType::BUY, book.toTicks(100.0)));
+     EXPECT_FALSE(book.cancelOrder(3));
+     EXPECT_EQ(book.advanceTime(100), 0u);
+ 
+     EXPECT_EQ(book.cancelAll(OrderType::SELL), 2u);
+     EXPECT_FALSE(book.bestAsk());
+     EXPECT_EQ(book.cancelAll(OrderType::SELL), 0u);
+ 
+     // Recycled nodes rest and match normally
+     add(OrderType::SELL, 99.0, 12);
+     EXPECT_EQ(book.getTrades().size(), 2u);
+     EXPECT_EQ(book.bestAskQty(), 2);
+ }
+ 
+ /** @test Owner cancel follows the owner's chain across sides and stops, skipping filled orders. */
+ TEST(DenseOrderBook, CancelByOwner) {
+     BookConfig cfg;
+     cfg.minPrice = 90.0;
+     cfg.maxPrice = 110.0;
+     DenseOrderBook book(cfg);
+     book.setAutoExport(false);
+ 
+     auto submit = [&](int id, OrderType t, double px, int qty, int owner) {
+         Order o(id, t, book.toTicks(px), qty, id);
+         o.owner = owner;
+         return o;
+     };
+     book.addOrder(submit(1, OrderType::BUY, 99.0, 5, 7));
+     book.addOrder(submit(2, OrderType::SELL, 101.0, 5, 7));
+     book.addOrder(submit(3, OrderType::SELL, 101.0, 5, 8));
+     Order stop = submit(4, OrderType::BUY, 105.0, 5, 7);
+     stop.kind = OrderKind::STOP_LIMIT;
+     stop.stopPrice = book.toTicks(104.0);
+     book.addOrder(stop);
+     book.addOrder(submit(5, OrderType::BUY, 98.0, 2, 7));
+     book.addOrder(submit(6, OrderType::SELL, 99.0, 5, 9));  // fills order 1
+ 
+     EXPECT_EQ(book.cancelByOwner(7), 3u);
+     EXPECT_FALSE(book.bestBid());
+     auto ask = book.getLevel(OrderType::SELL, book.toTicks(101.0));
+     ASSERT_TRUE(ask);
+     EXPECT_EQ(ask->orders, 1u);
+     EXPECT_EQ(book.cancelByOwner(7), 0u);
+     EXPECT_EQ(book.cancelByOwner(8), 1u);
+     EXPECT_FALSE(book.bestAsk());
+ }
+ 
+ /** @test Batched adds and cancels produce exactly the trades and depth of one-by-one submission. */
+ TEST(DenseOrderBook, BatchMatchesSequentialSubmission) {
+     BookConfig cfg;
+     cfg.minPrice = 90.0;
+     cfg.maxPrice = 110.0;
+     cfg.directOrderIds = true;
+     DenseOrderBook seq(cfg), batch(cfg);
+     seq.setAutoExport(false);
+     batch.setAutoExport(false);
+ 
+     std::mt19937 rng(7);
+     std::uniform_int_distribution<int> px(9900, 10100), qty(1, 9), side(0, 1);
+     std::vector<Order> orders;
+     std::vector<int> ids;
+     for (int i = 1; i <= 5000; ++i) {
+         orders.emplace_back(i, side(rng) ? OrderType::BUY : OrderType::SELL, px(rng), qty(rng), i);
+         if (i % 3 == 0) ids.push_back(i - 2);
+     }
+ 
+     for (const Order &o : orders) seq.addOrder(o);
+     std::size_t canceled = 0;
+     for (int id : ids) canceled += seq.cancelOrder(id) ? 1 : 0;
+ 
+     batch.addOrders(orders);
+     EXPECT_EQ(batch.cancelOrders(ids), canceled);
+ 
+     const auto &a = seq.getTrades(), &b = batch.getTrades();
+     ASSERT_EQ(a.size(), b.size());
+     for (std::size_t i = 0; i < a.size(); ++i) {
+         EXPECT_EQ(a[i].buyId, b[i].buyId);
+         EXPECT_EQ(a[i].sellId, b[i].sellId);
+         EXPECT_EQ(a[i].quantity, b[i].quantity);
+     }
+     for (OrderType s : {OrderType::BUY, OrderType::SELL}) {
+         std::vector<std::int64_t> da, db;
+         seq.forEachLevel(s, 1000, [&](const LevelInfo &l) { da.push_back(l.price); da.push_back(l.quantity); });
+         batch.forEachLevel(s, 1000, [&](const LevelInfo &l) { db.push_back(l.price); db.push_back(l.quantity); });
+         EXPECT_EQ(da, db);
+     }
+ }
+ 
+ // ------------------ MULTI-SYMBOL / THREADED ENGINES ------------------
+ 
+ /** @test Symbols intern to dense ids; books are created on first use and stay isolated. */
+ TEST(BookManager, RoutesBySymbolAndCreatesBooksLazily) {
+     BookManager engine;
+     engine.setAutoExport(false);
+     SymbolId aapl = engine.intern("AAPL");
+     SymbolId msft = engine.intern("MSFT");
+     EXPECT_EQ(aapl, 0u);
+     EXPECT_EQ(msft, 1u);
+     EXPECT_EQ(engine.intern("AAPL"), aapl);
+     EXPECT_EQ(engine.findSymbol("MSFT"), msft);
+     EXPECT_FALSE(engine.findSymbol("GOOG"));
+     EXPECT_EQ(engine.symbolName(msft), "MSFT");
+     EXPECT_EQ(engine.bookCount(), 0u);
+ 
+     // A per-symbol config applies if set before the book exists
+     BookConfig coarse;
+     coarse.tickSize = 0.05;
+     EXPECT_TRUE(engine.configure(msft, coarse));
+ 
+     engine.addOrder(aapl, Order(1, OrderType::SELL, 19000, 5, 1));
+     engine.addOrder(aapl, Order(2, OrderType::BUY, 19000, 3, 2));
+     EXPECT_EQ(engine.bookCount(), 1u);
+     EXPECT_EQ(engine.findBook(msft), nullptr);
+     EXPECT_FALSE(engine.cancelOrder(msft, 1));
+ 
+     engine.addOrder(msft, Order(1, OrderType::BUY, 8000, 4, 3));
+     EXPECT_FALSE(engine.configure(msft, BookConfig{}));
+     EXPECT_EQ(engine.bookCount(), 2u);
+     EXPECT_EQ(engine.book(aapl).getTrades().size(), 1u);
+     EXPECT_EQ(engine.book(aapl).bestAskQty(), 2);
+     EXPECT_EQ(engine.book(msft).getTrades().size(), 0u);
+     EXPECT_DOUBLE_EQ(engine.book(msft).toPrice(engine.book(msft).bestBid().value()), 400.0);
+ 
+     // Same order ID, different symbols: each cancel reaches only its own book
+     EXPECT_TRUE(engine.cancelOrder(msft, 1));
+     EXPECT_FALSE(engine.book(msft).bestBid());
+     EXPECT_EQ(engine.book(aapl).bestAskQty(), 2);
+ 
+     // Ids this manager never issued are rejected rather than indexed
+     SymbolId stranger = 7;
+     EXPECT_THROW(engine.book(stranger), std::out_of_range);
+     EXPECT_THROW(engine.configure(stranger, coarse), std::out_of_range);
+     EXPECT_THROW(engine.symbolName(stranger), std::out_of_range);
+     EXPECT_EQ(engine.findBook(stranger), nullptr);
+     EXPECT_FALSE(engine.cancelOrder(stranger, 1));
+ }
+ 
+ /** @test The shared clock expires GTT orders in every book, including books created after it moved. */
+ TEST(BookManager, AdvanceTimeReachesEveryBook) {
+     BookManager engine;
+     engine.setAutoExport(false);
+     SymbolId a = engine.intern("A");
+     SymbolId b = engine.intern("B");
+ 
+     Order gtt(1, OrderType::BUY, 10000, 5, 1);
+     gtt.expireAt = 10;
+     engine.addOrder(a, gtt);
+     EXPECT_EQ(engine.advanceTime(20), 1u);
+ 
+     // B joins at time 20, so an order expiring at 15 is already stale
+     EXPECT_EQ(engine.book(b).currentTime(), 20);
+     EXPECT_EQ(engine.book(b).sequence(), 0u);  // joining the clock is not an event
+     gtt.expireAt = 15;
+     engine.addOrder(b, gtt);
+     EXPECT_FALSE(engine.book(b).bestBid());
+ }
+ 
+ /** @test The SPSC ring keeps FIFO order across wrap-around, reports full and empty, and hands values across threads. */
+ TEST(SpscRing, FifoAcrossThreads) {
+     SpscRing<int> ring(3);
+     EXPECT_EQ(ring.capacity(), 4u);
+     for (int i = 0; i < 4; ++i)
+         EXPECT_TRUE(ring.tryPush(int(i)));
+     EXPECT_FALSE(ring.tryPush(4));
+     int v = -1;
+     EXPECT_TRUE(ring.tryPop(v));
+     EXPECT_EQ(v, 0);
+     EXPECT_TRUE(ring.tryPush(4));
+     for (int i = 1; i <= 4; ++i) {
+         EXPECT_TRUE(ring.tryPop(v));
+         EXPECT_EQ(v, i);
+     }
+     EXPECT_FALSE(ring.tryPop(v));
+ 
+     constexpr int N = 200000;
+     SpscRing<int> shared(64);
+     std::thread producer([&] {
+         for (int i = 0; i < N; ++i)
+             while (!shared.tryPush(int(i)))
+                 std::this_thread::yield();
+     });
+     bool ordered = true;
+     for (int expected = 0; expected < N;) {
+         if (shared.tryPop(v))
+             ordered &= (v == expected++);
+         else
+             std::this_thread::yield();
+     }
+     producer.join();
+     EXPECT_TRUE(ordered);
+     EXPECT_TRUE(shared.empty());
+ }
+ 
+ /** @test Sharding symbols over worker threads gives every symbol the same trades and book as single-threaded routing. */
+ TEST(ShardedEngine, MatchesSingleThreadedBookManager) {
+     ShardConfig shards;
+     shards.workers = 3;
+     shards.queueCapacity = 128;  // Small enough that the submitter waits on full rings
+     ShardedEngine sharded(shards);
+     BookManager reference;
+     reference.setAutoExport(false);
+ 
+     const int numSymbols = 7;
+     std::vector<SymbolId> ids;
+     for (int s = 0; s < numSymbols; ++s) {
+         std::string name = "SYM" + std::to_string(s);
+         ids.push_back(sharded.intern(name));
+         EXPECT_EQ(reference.intern(name), ids.back());
+     }
+ 
+     std::mt19937 rng(7);
+     std::uniform_int_distribution<int> symbolDist(0, numSymbols - 1), sideDist(0, 1), pxDist(9900, 10100), qtyDist(1, 5), action(0, 9);
+     std::vector<int> nextIds(numSymbols, 1);
+     for (long ts = 1; ts <= 20000; ++ts) {
+         SymbolId id = ids[symbolDist(rng)];
+         int a = action(rng);
+         if (a == 0 && nextIds[id] > 1) {
+             int victim = std::uniform_int_distribution<int>(1, nextIds[id] - 1)(rng);
+             sharded.cancelOrder(id, victim);
+             reference.cancelOrder(id, victim);
+         } else if (a == 1 && nextIds[id] > 1) {
+             int victim = std::uniform_int_distribution<int>(1, nextIds[id] - 1)(rng);
+             int qty = qtyDist(rng);
+             Price px = pxDist(rng);
+             sharded.modifyOrder(id, victim, qty, px, ts);
+             reference.modifyOrder(id, victim, qty, px, ts);
+         } else {
+             Order o(nextIds[id]++, sideDist(rng) ? OrderType::BUY : OrderType::SELL, pxDist(rng), qtyDist(rng), ts);
+             sharded.addOrder(id, o);
+             reference.addOrder(id, o);
+         }
+     }
+     sharded.drain();
+ 
+     int books = 0;
+     sharded.forEachBook([&](SymbolId id, OrderBook &book) {
+         ++books;
+         OrderBook *expected = reference.findBook(id);
+         ASSERT_NE(expected, nullptr);
+         const auto &got = book.getTrades();
+         const auto &want = expected->getTrades();
+         ASSERT_EQ(got.size(), want.size()) << sharded.symbolName(id);
+         for (size_t i = 0; i < got.size(); ++i) {
+             EXPECT_EQ(got[i].buyId, want[i].buyId);
+             EXPECT_EQ(got[i].sellId, want[i].sellId);
+             EXPECT_EQ(got[i].price, want[i].price);
+             EXPECT_EQ(got[i].quantity, want[i].quantity);
+         }
+         EXPECT_EQ(book.bestBid(), expected->bestBid());
+         EXPECT_EQ(book.bestAsk(), expected->bestAsk());
+     });
+     EXPECT_EQ(books, numSymbols);
+     sharded.stop();
+ }
+ 
+ /** @test An add for a symbol that was never interned is rejected on the worker instead of ending the process. */
+ TEST(ShardedEngine, RejectsAddForUninternedSymbol) {
+     ShardConfig shards;
+     shards.workers = 2;
+     shards.pinThreads = false;
+     ShardedEngine sharded(shards);
+     SymbolId known = sharded.intern("AAPL");
+ 
+     sharded.addOrder(known + 5, Order(1, OrderType::BUY, 100, 5, 1));
+     sharded.addOrder(known, Order(1, OrderType::SELL, 100, 5, 2));
+     sharded.addOrder(known, Order(2, OrderType::BUY, 100, 2, 3));
+     sharded.drain();
+     EXPECT_EQ(sharded.rejectedCount(), 1u);
+ 
+     int books = 0;
+     sharded.forEachBook([&](SymbolId id, OrderBook &book) {
+         ++books;
+         EXPECT_EQ(id, known);
+         EXPECT_EQ(book.getTradeCount(), 1u);
+         EXPECT_EQ(book.bestAskQty(), 3);
+     });
+     EXPECT_EQ(books, 1);
+     sharded.stop();
+ }
+  
+ /** @test Concurrent producers get gap-free sequence numbers, each in its own submission order, delivered in sequence. */
+ TEST(MpscSequencer, GapFreeSequenceAcrossProducers) {
+     constexpr int Producers = 4, PerProducer = 50000;
+     MpscSequencer<std::pair<int, int>> sequencer(64);
+     EXPECT_EQ(sequencer.capacity(), 64u);
+ 
+     std::vector<std::vector<std::uint64_t>> seqs(Producers);
+     std::vector<std::thread> producers;
+     for (int p = 0; p < Producers; ++p)
+         producers.emplace_back([&, p] {
+             for (int i = 0; i < PerProducer; ++i)
+                 seqs[p].push_back(sequencer.publish({p, i}));
+         });
+ 
+     std::vector<int> nextFromProducer(Producers, 0);
+     std::vector<std::pair<int, int>> bySeq(Producers * PerProducer);
+     bool inOrder = true;
+     std::pair<int, int> item;
+     std::uint64_t seq = 0, expected = 0;
+     while (expected < bySeq.size()) {
+         if (!sequencer.tryConsume(item, seq)) {
+             std::this_thread::yield();
+             continue;
+         }
+         inOrder &= (seq == expected++) && (item.second == nextFromProducer[item.first]++);
+         bySeq[seq] = item;
+     }
+     for (auto &t : producers)
+         t.join();
+     EXPECT_TRUE(inOrder);
+     EXPECT_EQ(sequencer.claimed(), bySeq.size());
+     for (int p = 0; p < Producers; ++p)
+         for (int i = 0; i < PerProducer; ++i)
+             ASSERT_EQ(bySeq[seqs[p][i]], std::make_pair(p, i));
+ }
+ 
+ /** @test Gateway threads submitting concurrently produce the book that replaying their requests in sequence order gives. */
+ TEST(SequencedEngine, MatchesReplayInSequenceOrder) {
+     SequencerConfig queue;
+     queue.capacity = 256;
+     SequencedEngine engine(queue);
+     SymbolId a = engine.intern("A");
+     SymbolId b = engine.intern("B");
+ 
+     // Each gateway owns a disjoint ID range and logs what it submitted under the returned sequence
+     struct Logged { std::uint64_t seq; SymbolId symbol; bool cancel; Order order; };
+     constexpr int Gateways = 3, PerGateway = 4000;
+     std::vector<std::vector<Logged>> logs(Gateways);
+     std::vector<std::thread> gateways;
+     for (int g = 0; g < Gateways; ++g)
+         gateways.emplace_back([&, g] {
+             std::mt19937 rng(100 + g);
+             std::uniform_int_distribution<int> pxDist(9950, 10050), qtyDist(1, 5), coin(0, 1), action(0, 9);
+             int nextId = g * PerGateway + 1;
+             for (int i = 0; i < PerGateway; ++i) {
+                 SymbolId sym = coin(rng) ? a : b;
+                 if (action(rng) == 0 && nextId > g * PerGateway + 1) {
+                     int victim = std::uniform_int_distribution<int>(g * PerGateway + 1, nextId - 1)(rng);
+                     Order o(victim, OrderType::BUY, 0, 0, 0);
+                     logs[g].push_back({engine.cancelOrder(sym, victim), sym, true, o});
+                 } else {
+                     Order o(nextId++, coin(rng) ? OrderType::BUY : OrderType::SELL, pxDist(rng), qtyDist(rng), 0);
+                     logs[g].push_back({engine.addOrder(sym, o), sym, false, o});
+                 }
+             }
+         });
+     for (auto &t : gateways)
+         t.join();
+     engine.drain();
+ 
+     std::vector<Logged> all;
+     for (auto &log : logs)
+         all.insert(all.end(), log.begin(), log.end());
+     std::sort(all.begin(), all.end(), [](const Logged &x, const Logged &y) { return x.seq < y.seq; });
+     ASSERT_EQ(all.size(), size_t(Gateways * PerGateway));
+     EXPECT_EQ(all.front().seq, 2u);  // 0 and 1 were the interns
+     EXPECT_EQ(all.back().seq, all.size() + 1);
+ 
+     BookManager reference;
+     reference.setAutoExport(false);
+     reference.intern("A");
+     reference.intern("B");
+     for (const Logged &l : all) {
+         if (l.cancel) {
+             reference.cancelOrder(l.symbol, l.order.id);
+         } else {
+             Order o = l.order;
+             o.timestamp = static_cast<long>(l.seq + 1);
+             reference.addOrder(l.symbol, o);
+         }
+     }
+ 
+     for (SymbolId sym : {a, b}) {
+         OrderBook *got = engine.findBook(sym);
+         OrderBook *want = reference.findBook(sym);
+         ASSERT_NE(got, nullptr);
+         ASSERT_NE(want, nullptr);
+         ASSERT_EQ(got->getTrades().size(), want->getTrades().size());
+         for (size_t i = 0; i < got->getTrades().size(); ++i) {
+             EXPECT_EQ(got->getTrades()[i].buyId, want->getTrades()[i].buyId);
+             EXPECT_EQ(got->getTrades()[i].sellId, want->getTrades()[i].sellId);
+             EXPECT_EQ(got->getTrades()[i].quantity, want->getTrades()[i].quantity);
+             EXPECT_EQ(got->getTrades()[i].timestamp, want->getTrades()[i].timestamp);
+         }
+         EXPECT_EQ(got->bestBid(), want->bestBid());
+         EXPECT_EQ(got->bestAsk(), want->bestAsk());
+     }
+     engine.stop();
+ }
+ 
+ /** @test An add for an un-interned symbol is rejected by the matcher but still consumes its sequence number. */
+ TEST(SequencedEngine, RejectedAddKeepsSequence) {
+     SequencerConfig queue;
+     queue.capacity = 16;
+     queue.pinThread = false;
+     SequencedEngine engine(queue);
+     SymbolId known = engine.intern("A");
+ 
+     std::uint64_t rejectedSeq = engine.addOrder(known + 1, Order(1, OrderType::BUY, 100, 5, 0));
+     EXPECT_EQ(engine.addOrder(known, Order(1, OrderType::SELL, 100, 5, 0)), rejectedSeq + 1);
+     std::uint64_t takerSeq = engine.addOrder(known, Order(2, OrderType::BUY, 100, 2, 0));
+     EXPECT_EQ(takerSeq, rejectedSeq + 2);
+     engine.drain();
+     EXPECT_EQ(engine.rejectedCount(), 1u);
+ 
+     // Timestamps are sequence + 1, so the fill shows the rejected slot was consumed in order
+     OrderBook *book = engine.findBook(known);
+     ASSERT_NE(book, nullptr);
+     ASSERT_EQ(book->getTrades().size(), 1u);
+     EXPECT_EQ(book->getTrades()[0].timestamp, static_cast<long>(takerSeq) + 1);
+     EXPECT_EQ(engine.findBook(known + 1), nullptr);
+     engine.stop();
+ }
+ 
+ /** @test Items pass through every stage of a StageRing in order, in place, with slots recycled across laps. */
+ TEST(StageRing, StagesSeeEveryItemInOrder) {
+     constexpr int N = 100000;
+     StageRing<long> ring(16, 3);
+     EXPECT_EQ(ring.capacity(), 16u);
+     EXPECT_EQ(ring.available(0), 16u);
+     EXPECT_EQ(ring.available(1), 0u);
+ 
+     // Stage 1 doubles each value in place; stage 2 checks order and recycles the slot
+     std::thread doubler([&] {
+         for (int seen = 0; seen < N;) {
+             std::size_t n = ring.available(1);
+             for (std::size_t i = 0; i < n; ++i)
+                 ring.at(1, i) *= 2;
+             ring.commit(1, n);
+             seen += static_cast<int>(n);
+             if (n == 0)
+                 std::this_thread::yield();
+         }
+     });
+     std::thread checker([&] {
+         long expected = 0;
+         bool ordered = true;
+         while (expected < N) {
+             std::size_t n = ring.available(2);
+             for (std::size_t i = 0; i < n; ++i)
+                 ordered &= ring.at(2, i) == 2 * expected++;
+             ring.commit(2, n);
+             if (n == 0)
+                 std::this_thread::yield();
+         }
+         EXPECT_TRUE(ordered);
+     });
+     for (long next = 0; next < N;) {
+         std::size_t n = std::min<std::size_t>(ring.available(0), N - next);
+         for (std::size_t i = 0; i < n; ++i)
+             ring.at(0, i) = next++;
+         ring.commit(0, n);
+         if (n == 0)
+             std::this_thread::yield();
+     }
+     doubler.join();
+     checker.join();
+     EXPECT_EQ(ring.available(0), 16u);
+ }
+ 
+ /** @test The CLI pipeline echoes every line with its response in input order and journals a replayable script. */
+ TEST(CliPipeline, RunsScriptInOrderAndJournals) {
+     const std::string journalPath = testing::TempDir() + "lob_pipeline_journal.txt";
+     std::remove(journalPath.c_str());
+ 
+     PipelineConfig config;
+     config.capacity = 4;  // Forces the stages to wrap many times
+     config.journalPath = journalPath;
+     std::string script =
+         "SELL 100.5 10\n"
+         "BUY 100.5 4\n"
+         "CANCEL 1\n"
+         "CANCEL 1\n"
+         "\n"
+         "@X BUY 50 3\n"
+         "@X MODIFY 1 2 51\n"
+         "TIME 5\n"
+         "FOO\n"
+         "PRINT\n"
+         "EXIT\n"
+         "BUY 1 1\n";
+     std::istringstream in(script);
+     std::ostringstream out, err;
+     {
+         CliPipeline pipeline(config);
+         pipeline.run(in, out, err);
+ 
+         OrderBook *x = pipeline.books().findBook(*pipeline.books().findSymbol("X"));
+         ASSERT_NE(x, nullptr);
+         EXPECT_EQ(x->bestBidQty(), 2);
+         EXPECT_EQ(x->toPrice(x->bestBid().value()), 51.0);
+     }
+ 
+     EXPECT_EQ(out.str(),
+               ">SELL 100.5 10\n"
+               ">BUY 100.5 4\n"
+               ">CANCEL 1\nOrder cancelled.\n"
+               ">CANCEL 1\nOrder not found.\n"
+               ">@X BUY 50 3\n"
+               ">@X MODIFY 1 2 51\nOrder modified.\n"
+               ">TIME 5\n0 orders expired.\n"
+               ">FOO\n"
+               ">PRINT\n\nOrder Book:\nBIDS:\nASKS:\nTotal Volume Traded: 4 units\n"
+               ">EXIT\n");
+     EXPECT_EQ(err.str(), "Unknown command: FOO\n");
+ 
+     // The journal holds the processed lines (blank lines and anything after EXIT dropped)
+     std::ifstream journal(journalPath);
+     std::stringstream replay;
+     replay << journal.rdbuf();
+     EXPECT_EQ(replay.str(), "SELL 100.5 10\nBUY 100.5 4\nCANCEL 1\nCANCEL 1\n@X BUY 50 3\n@X MODIFY 1 2 51\nTIME 5\nFOO\nPRINT\nEXIT\n");
+     std::remove(journalPath.c_str());
+ }
+ 
+ /** @test Only commands that bring orders create a book; reads, cancels and modifies on a new symbol report it unknown. */
+ TEST(CliPipeline, UnknownSymbolCreatesNoBook) {
+     std::istringstream in(
+         "PRINT\n"
+         "@TYPO PRINT\n"
+         "@TYPO CANCEL 1\n"
+         "@TYPO MODIFY 1 2 50\n"
+         "@TYPO CANCEL_ALL BUY\n"
+         "@NEW BUY 50 3\n"
+         "@NEW CANCEL 1\n");
+     std::ostringstream out, err;
+     CliPipeline pipeline;
+     pipeline.run(in, out, err);
+ 
+     BookManager &books = pipeline.books();
+     EXPECT_EQ(books.bookCount(), 2u);  // DEFAULT and NEW
+     EXPECT_EQ(books.findBook(*books.findSymbol("TYPO")), nullptr);
+     EXPECT_NE(books.findBook(*books.findSymbol("NEW")), nullptr);
+     EXPECT_EQ(out.str(),
+               ">PRINT\n\nOrder Book:\nBIDS:\nASKS:\nTotal Volume Traded: 0 units\n"
+               ">@TYPO PRINT\n"
+               ">@TYPO CANCEL 1\n"
+               ">@TYPO MODIFY 1 2 50\n"
+               ">@TYPO CANCEL_ALL BUY\n"
+               ">@NEW BUY 50 3\n"
+               ">@NEW CANCEL 1\nOrder cancelled.\n");
+     EXPECT_EQ(err.str(), "Unknown symbol: TYPO\nUnknown symbol: TYPO\nUnknown symbol: TYPO\nUnknown symbol: TYPO\n");
+ }
+  
+ /** @test The top-of-book feed tracks the BBO and last trade, stamped with the book's event sequence. */
+ TEST(TopOfBook, PublishesBboAndLastTradeWithEventSequence) {
+     OrderBook book;
+     book.setAutoExport(false);
+     SeqlockTopOfBook feed;
+     book.setTopOfBookFeed(&feed);
+     TopOfBook top = feed.read();
+     EXPECT_EQ(top.sequence, 0u);
+     EXPECT_EQ(top.bidQty, 0);
+     EXPECT_EQ(top.askQty, 0);
+ 
+     book.addOrder(Order(1, OrderType::BUY, 100, 5, 1));
+     book.addOrder(Order(2, OrderType::SELL, 105, 7, 2));
+     book.addOrder(Order(3, OrderType::BUY, 90, 9, 3));  // Behind the best bid: still an event
+     top = feed.read();
+     EXPECT_EQ(top.sequence, 3u);
+     EXPECT_EQ(top.bidPrice, 100);
+     EXPECT_EQ(top.bidQty, 5);
+     EXPECT_EQ(top.askPrice, 105);
+     EXPECT_EQ(top.askQty, 7);
+     EXPECT_EQ(top.lastQty, 0);
+ 
+     // One publish covers the trade and the depth it left behind
+     book.addOrder(Order(4, OrderType::BUY, 105, 3, 4));
+     top = feed.read();
+     EXPECT_EQ(top.sequence, 4u);
+     EXPECT_EQ(top.askQty, 4);
+     EXPECT_EQ(top.lastPrice, 105);
+     EXPECT_EQ(top.lastQty, 3);
+     EXPECT_EQ(top.lastTime, 4);
+ 
+     // A repricing modify is a single event, not a cancel followed by an add
+     EXPECT_TRUE(book.modifyOrder(1, 6, 101, 5));
+     top = feed.read();
+     EXPECT_EQ(top.sequence, 5u);
+     EXPECT_EQ(top.bidPrice, 101);
+     EXPECT_EQ(top.bidQty, 6);
+ 
+     // Batches count each element; a miss is still an event
+     EXPECT_EQ(book.cancelOrders(std::vector<int>{2, 3}), 2u);
+     EXPECT_FALSE(book.cancelOrder(99));
+     top = feed.read();
+     EXPECT_EQ(top.sequence, 8u);
+     EXPECT_EQ(top.sequence, book.sequence());
+     EXPECT_EQ(top.askQty, 0);
+     EXPECT_TRUE(top.sameState(book.topOfBook()));
+ 
+     book.setTopOfBookFeed(nullptr);
+     book.cancelOrder(1);
+     EXPECT_EQ(book.sequence(), 9u);
+     EXPECT_EQ(feed.sequence(), 8u);
+ }
+ 
+ /** @test A reader thread only ever sees snapshots the matcher published, never a mix of two. */
+ TEST(TopOfBook, ConcurrentReaderSeesConsistentSnapshots) {
+     constexpr int N = 20000;
+     OrderBook book;
+     book.setAutoExport(false);
+     SeqlockTopOfBook feed;
+     book.setTopOfBookFeed(&feed);
+     book.addOrder(Order(1, OrderType::BUY, 1000, 1000, 1));
+ 
+     // Every published bid has quantity equal to its price, so a torn copy breaks the pairing
+     std::atomic<bool> done{false};
+     std::thread reader([&] {
+         std::uint64_t lastSequence = 0;
+         bool consistent = true, monotonic = true;
+         while (!done.load(std::memory_order_acquire)) {
+             TopOfBook top;
+             if (!feed.tryRead(top))
+                 continue;
+             consistent &= top.bidQty == top.bidPrice;
+             monotonic &= top.sequence >= lastSequence;
+             lastSequence = top.sequence;
+         }
+         EXPECT_TRUE(consistent);
+         EXPECT_TRUE(monotonic);
+     });
+     for (int i = 1; i <= N; ++i) {
+         Price px = 1000 + i % 500;
+         book.modifyOrder(1, static_cast<int>(px), px, i + 1);
+     }
+     done.store(true, std::memory_order_release);
+     reader.join();
+ 
+     TopOfBook top = feed.read();
+     EXPECT_EQ(top.sequence, static_cast<std::uint64_t>(N) + 1);
+     EXPECT_EQ(top.bidPrice, 1000 + N % 500);
+     EXPECT_EQ(top.bidQty, top.bidPrice);
+ }
+ 
+ // ------------------ DENSE LADDER BACKEND ------------------
+ 
+ /** @test Bitmap next/prev lookups cross word and layer boundaries. */
+ TEST(TickBitmap, FindNextAndPrev) {
+     TickBitmap bits(300000);
+     EXPECT_EQ(bits.findNext(0), TickBitmap::npos);
+     EXPECT_EQ(bits.findPrev(299999), TickBitmap::npos);
+ 
+     bits.set(5);
+     bits.set(4100);
+     bits.set(299999);
+     EXPECT_EQ(bits.findNext(0), 5u);
+     EXPECT_EQ(bits.findNext(6), 4100u);
+     EXPECT_EQ(bits.findNext(4101), 299999u);
+     EXPECT_EQ(bits.findPrev(299998), 4100u);
+     EXPECT_EQ(bits.findPrev(4099), 5u);
+     EXPECT_EQ(bits.findPrev(4), TickBitmap::npos);
+ 
+     bits.clear(4100);
+     EXPECT_FALSE(bits.test(4100));
+     EXPECT_EQ(bits.findNext(6), 299999u);
+     EXPECT_EQ(bits.findPrev(299998), 5u);
+ }
+ 
+ /** @test Dense book sweeps levels in price order and moves best past emptied levels. */
+ TEST(DenseOrderBook, SweepsLevelsInPriceOrder) {
+     BookConfig cfg;
+     cfg.tickSize = 0.01;
+     cfg.minPrice = 90.0;
+     cfg.maxPrice = 110.0;
+     DenseOrderBook book(cfg);
+     book.setAutoExport(false);
+ 
+     book.addOrder(Order(1, OrderType::SELL, book.toTicks(101.00), 2, 1));
+     book.addOrder(Order(2, OrderType::SELL, book.toTicks(100.50), 2, 2));
+     book.addOrder(Order(3, OrderType::SELL, book.toTicks(102.00), 2, 3));
+     EXPECT_TRUE(book.cancelOrder(2));
+     book.addOrder(Order(4, OrderType::BUY, book.toTicks(102.00), 3, 4));
+ 
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 2u);
+     EXPECT_EQ(tr[0].sellId, 1);
+     EXPECT_EQ(tr[1].sellId, 3);
+     EXPECT_EQ(tr[1].quantity, 1);
+ }
+ 
+ /** @test Orders outside the configured band are rejected. */
+ TEST(DenseOrderBook, RejectsOutOfBandPrices) {
+     BookConfig cfg;
+     cfg.minPrice = 90.0;
+     cfg.maxPrice = 110.0;
+     DenseOrderBook book(cfg);
+     book.setAutoExport(false);
+ 
+     book.addOrder(Order(1, OrderType::BUY, book.toTicks(120.0), 5, 1));
+     book.addOrder(Order(2, OrderType::SELL, book.toTicks(80.0), 5, 2));
+     EXPECT_FALSE(book.cancelOrder(1));
+     EXPECT_FALSE(book.cancelOrder(2));
+     EXPECT_TRUE(book.getTrades().empty());
+ }
+ 
+ /** @test Leaving auction mode uncrosses whatever has accumulated. */
+ TEST(DenseOrderBook, LeavingAuctionUncrosses) {
+     BookConfig cfg;
+     cfg.minPrice = 90.0;
+     cfg.maxPrice = 110.0;
+     DenseOrderBook book(cfg);
+     book.setAutoExport(false);
+ 
+     book.setAuctionMode(true);
+     book.addOrder(Order(1, OrderType::SELL, book.toTicks(100.0), 3, 1));
+     book.addOrder(Order(2, OrderType::BUY, book.toTicks(104.0), 2, 2));
+     book.addOrder(Order(3, OrderType::BUY, book.toTicks(101.0), 2, 3));
+     EXPECT_EQ(book.bestBid(), book.toTicks(104.0));
+     EXPECT_EQ(book.bestAsk(), book.toTicks(100.0));
+ 
+     book.setAuctionMode(false);
+     EXPECT_FALSE(book.inAuction());
+     ASSERT_EQ(book.getTrades().size(), 2u);
+     EXPECT_EQ(book.getTrades()[0].buyId, 2);
+     EXPECT_EQ(book.getTrades()[0].price, book.toTicks(100.0));
+     EXPECT_EQ(book.getLevel(OrderType::BUY, book.toTicks(101.0))->quantity, 1);
+     EXPECT_FALSE(book.bestAsk().has_value());
+ }
+ 
+ /** @test A tick whose level an uncross fully filled starts from empty totals when it is reused. */
+ TEST(DenseOrderBook, UncrossedLevelReusedWithFreshTotals) {
+     BookConfig cfg;
+     cfg.tickSize = 1.0;
+     cfg.minPrice = 0.0;
+     cfg.maxPrice = 1000.0;
+     DenseOrderBook book(cfg);
+     book.setAutoExport(false);
+ 
+     book.setAuctionMode(true);
+     book.addOrder(Order(1, OrderType::BUY, 100, 10, 1));
+     book.addOrder(Order(2, OrderType::SELL, 100, 10, 2));
+     book.setAuctionMode(false);
+     ASSERT_EQ(book.getTrades().size(), 1u);
+     EXPECT_FALSE(book.bestBid().has_value());
+     EXPECT_FALSE(book.bestAsk().has_value());
+ 
+     book.addOrder(Order(3, OrderType::BUY, 100, 5, 3));
+     auto level = book.getLevel(OrderType::BUY, 100);
+     ASSERT_TRUE(level.has_value());
+     EXPECT_EQ(level->quantity, 5);
+     EXPECT_EQ(level->orders, 1u);
+     EXPECT_EQ(book.bestBidQty(), 5);
+ 
+     book.addOrder(Order(4, OrderType::SELL, 100, 5, 4));
+     EXPECT_FALSE(book.bestBid().has_value());
+     EXPECT_EQ(book.getTrades().size(), 2u);
+ }
+ 
+ // ------------------ STORAGE / INDEX STRUCTURES ------------------
+ 
+ /** @test Released pool nodes are recycled instead of growing the slab. */
+ TEST(OrderPool, RecyclesReleasedNodes) {
+     OrderPool pool;
+     pool.reserve(10);
+     std::size_t cap = pool.capacity();
+ 
+     OrderHandle a = pool.acquire(Order(1, OrderType::BUY, 100, 1, 1));
+     OrderHandle b = pool.acquire(Order(2, OrderType::BUY, 100, 1, 2));
+     pool.release(a);
+     OrderHandle c = pool.acquire(Order(3, OrderType::BUY, 100, 1, 3));
+ 
+     EXPECT_EQ(c, a);
+     EXPECT_EQ(pool[c].order.id, 3);
+     EXPECT_EQ(pool[b].order.id, 2);
+     EXPECT_EQ(pool.size(), 2u);
+     EXPECT_EQ(pool.capacity(), cap);
+ }
+ 
+ /** @test Flat ID map agrees with std::unordered_map under random insert/erase churn. */
+ TEST(OrderIdMap, MatchesReferenceUnderChurn) {
+     OrderIdMap<OrderHandle> map;
+     std::unordered_map<int, OrderHandle> ref;
+     std::mt19937 rng(7);
+     std::uniform_int_distribution<int> keyDist(-500, 2000);
+ 
+     for (int i = 0; i < 200000; ++i) {
+         int key = keyDist(rng);
+         if (rng() % 3 == 0) {
+             EXPECT_EQ(map.erase(key), ref.erase(key) == 1);
+         } else {
+             map.insert(key, static_cast<OrderHandle>(i));
+             ref[key] = static_cast<OrderHandle>(i);
+         }
+     }
+ 
+     ASSERT_EQ(map.size(), ref.size());
+     for (int key = -500; key <= 2000; ++key) {
+         const OrderHandle *v = map.find(key);
+         auto it = ref.find(key);
+         ASSERT_EQ(v != nullptr, it != ref.end()) << "key " << key;
+         if (v) {
+             EXPECT_EQ(*v, it->second);
+         }
+     }
+ }
+ 
+ /** @test Reserve sizes the table up front; INT_MIN is a usable key. */
+ TEST(OrderIdMap, ReserveAndSentinelKey) {
+     OrderIdMap<OrderHandle> map;
+     map.reserve(1000);
+     std::size_t cap = map.capacity();
+     EXPECT_GE(cap, 1000u);
+ 
+     for (int i = 0; i < 1000; ++i) map.insert(i, static_cast<OrderHandle>(i));
+     EXPECT_EQ(map.capacity(), cap);
+ 
+     map.insert(INT_MIN, 42);
+     ASSERT_NE(map.find(INT_MIN), nullptr);
+     EXPECT_EQ(*map.find(INT_MIN), 42u);
+     EXPECT_EQ(map.size(), 1001u);
+     EXPECT_TRUE(map.erase(INT_MIN));
+     EXPECT_EQ(map.find(INT_MIN), nullptr);
+ }
+ 
+ /** @test Direct window agrees with a reference map for dense IDs mixed with sparse client IDs. */
+ TEST(OrderIndex, DirectWindowWithSparseFallback) {
+     OrderIndex index(true);
+     std::unordered_map<int, OrderHandle> ref;
+     std::mt19937 rng(11);
+     int nextId = 1;
+     std::vector<int> live;
+ 
+     for (int i = 0; i < 300000; ++i) {
+         unsigned r = rng() % 10;
+         if (r < 5) {
+             int id = nextId++;
+             index.insert(id, static_cast<OrderHandle>(i));
+             ref[id] = static_cast<OrderHandle>(i);
+             live.push_back(id);
+         } else if (r == 5) {
+             int id = 1'000'000'000 + static_cast<int>(rng() % 1000); // Sparse client ID
+             index.insert(id, static_cast<OrderHandle>(i));
+             ref[id] = static_cast<OrderHandle>(i);
+             live.push_back(id);
+         } else if (!live.empty()) {
+             std::size_t pick = rng() % live.size();
+             int id = live[pick];
+             live[pick] = live.back();
+             live.pop_back();
+             EXPECT_EQ(index.erase(id), ref.erase(id) == 1);
+         }
+     }
+ 
+     ASSERT_EQ(index.size(), ref.size());
+     for (const auto &[id, h] : ref)
+         ASSERT_EQ(index.find(id), h) << "id " << id;
+     EXPECT_EQ(index.find(nextId), NullHandle);
+     EXPECT_EQ(index.find(-5), NullHandle);
+ }
+ 
+ /** @test A long-lived order survives the window sliding past it. */
+ TEST(OrderIndex, StragglerMovesToFallback) {
+     OrderIndex index(true);
+     index.insert(1, 7);
+     for (int id = 2; id < 5'000'000; ++id) {
+         index.insert(id, 1);
+         index.erase(id);
+     }
+     EXPECT_EQ(index.find(1), 7u);
+     EXPECT_EQ(index.size(), 1u);
+     EXPECT_TRUE(index.erase(1));
+     EXPECT_EQ(index.find(1), NullHandle);
+ }
+ 
+ /** @test Book behaves identically with the direct-indexed ID mode enabled. */
+ TEST(OrderIndex, BookWithDirectIds) {
+     BookConfig cfg;
+     cfg.directOrderIds = true;
+     OrderBook book(cfg);
+     book.setAutoExport(false);
+ 
+     book.addOrder(Order(1, OrderType::BUY, book.toTicks(100.0), 5, 1));
+     book.addOrder(Order(2, OrderType::BUY, book.toTicks(100.0), 5, 2));
+     book.addOrder(Order(50'000'000, OrderType::BUY, book.toTicks(99.0), 5, 3));
+     EXPECT_TRUE(book.cancelOrder(1));
+     EXPECT_TRUE(book.modifyOrder(50'000'000, 3, book.toTicks(99.5), 4));
+     book.addOrder(Order(3, OrderType::SELL, book.toTicks(99.0), 8, 5));
+ 
+     const auto &tr = book.getTrades();
+     ASSERT_EQ(tr.size(), 2u);
+     EXPECT_EQ(tr[0].buyId, 2);
+     EXPECT_EQ(tr[1].buyId, 50'000'000);
+     EXPECT_FALSE(book.cancelOrder(2));
+     EXPECT_FALSE(book.cancelOrder(50'000'000));
+ }
+ 
+ /** @test Timer wheel fires every entry exactly once, in time order, across levels and overflow. */
+ TEST(TimerWheel, MatchesReferenceSchedule) {
+     OrderPool pool;
+     TimerWheel wheel(100);
+     std::mt19937_64 rng(11);
+     std::multimap<long, OrderHandle> reference;
+     std::vector<OrderHandle> live;
+ 
+     for (int i = 0; i < 3000; ++i) {
+         long horizon = (i % 3 == 0) ? (1L << 26) : (i % 3 == 1) ? 5000 : 63;
+         long expiry = wheel.now() + 1 + static_cast<long>(rng() % horizon);
+         OrderHandle h = pool.acquire(Order(i, OrderType::BUY, 0, 1, 0));
+         pool[h].order.expireAt = expiry;
+         wheel.schedule(pool, h);
+         reference.emplace(expiry, h);
+         live.push_back(h);
+     }
+     for (int i = 0; i < 500; ++i) { // Cancel a random subset
+         OrderHandle h = live[rng() % live.size()];
+         if (pool[h].timerSlot == NoTimerSlot)
+             continue;
+         wheel.cancel(pool, h);
+         for (auto it = reference.begin(); it != reference.end(); ++it)
+             if (it->second == h) { reference.erase(it); break; }
+     }
+     ASSERT_EQ(wheel.size(), reference.size());
+ 
+     long lastFired = 0;
+     while (!reference.empty()) {
+         long now = wheel.now() + 1 + static_cast<long>(rng() % 200000);
+         std::size_t fired = wheel.advance(pool, now, [&](OrderHandle h) {
+             long expiry = pool[h].order.expireAt;
+             EXPECT_LE(expiry, now);
+             EXPECT_GE(expiry, lastFired);
+             lastFired = expiry;
+         });
+         std::size_t due = std::distance(reference.begin(), reference.upper_bound(now));
+         ASSERT_EQ(fired, due);
+         reference.erase(reference.begin(), reference.upper_bound(now));
+     }
+     EXPECT_EQ(wheel.size(), 0u);
+ }